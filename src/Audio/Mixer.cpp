@@ -0,0 +1,436 @@
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "Audio/Mixer.h"
+#include "Common/FramePacer.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(__EMSCRIPTEN__)
+#define MIXER_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(MIXER_AVX2)
+#define MIXER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Every kernel sums count rows of length samples, spaced stride
+    // apart, into interleaved stereo with one gain per row and side.
+    void mixScalar(const float *rows, size_t stride, size_t count, const float *lefts, const float *rights, float *stream, int start, int length) {
+        for (int i = start; i < length; i++) {
+            float left = 0.0f;
+            float right = 0.0f;
+
+            for (size_t v = 0; v < count; v++) {
+                float sample = rows[v * stride + i];
+                left += sample * lefts[v];
+                right += sample * rights[v];
+            }
+
+            stream[i * 2] = left;
+            stream[i * 2 + 1] = right;
+        }
+    }
+
+#ifdef MIXER_SSE2
+    void mixSSE2(const float *rows, size_t stride, size_t count, const float *lefts, const float *rights, float *stream, int length) {
+        int i = 0;
+
+        for (; i + 4 <= length; i += 4) {
+            __m128 left = _mm_setzero_ps();
+            __m128 right = _mm_setzero_ps();
+
+            for (size_t v = 0; v < count; v++) {
+                __m128 sample = _mm_loadu_ps(rows + v * stride + i);
+                left = _mm_add_ps(left, _mm_mul_ps(sample, _mm_set1_ps(lefts[v])));
+                right = _mm_add_ps(right, _mm_mul_ps(sample, _mm_set1_ps(rights[v])));
+            }
+
+            _mm_storeu_ps(stream + i * 2, _mm_unpacklo_ps(left, right));
+            _mm_storeu_ps(stream + i * 2 + 4, _mm_unpackhi_ps(left, right));
+        }
+
+        mixScalar(rows, stride, count, lefts, rights, stream, i, length);
+    }
+#endif
+
+#ifdef MIXER_AVX2
+    __attribute__((target("avx2,fma")))
+    void mixAVX2(const float *rows, size_t stride, size_t count, const float *lefts, const float *rights, float *stream, int length) {
+        int i = 0;
+
+        for (; i + 8 <= length; i += 8) {
+            __m256 left = _mm256_setzero_ps();
+            __m256 right = _mm256_setzero_ps();
+
+            for (size_t v = 0; v < count; v++) {
+                __m256 sample = _mm256_loadu_ps(rows + v * stride + i);
+                left = _mm256_fmadd_ps(sample, _mm256_set1_ps(lefts[v]), left);
+                right = _mm256_fmadd_ps(sample, _mm256_set1_ps(rights[v]), right);
+            }
+
+            // unpack works within 128 bit lanes, permute puts the halves
+            // back in sample order
+            __m256 low = _mm256_unpacklo_ps(left, right);
+            __m256 high = _mm256_unpackhi_ps(left, right);
+
+            _mm256_storeu_ps(stream + i * 2, _mm256_permute2f128_ps(low, high, 0x20));
+            _mm256_storeu_ps(stream + i * 2 + 8, _mm256_permute2f128_ps(low, high, 0x31));
+        }
+
+        mixScalar(rows, stride, count, lefts, rights, stream, i, length);
+    }
+
+    bool hasAVX2() {
+        static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return supported;
+    }
+#endif
+
+    void mixRows(const float *rows, size_t stride, size_t count, const float *lefts, const float *rights, float *stream, int length) {
+#ifdef MIXER_AVX2
+        if (hasAVX2()) {
+            mixAVX2(rows, stride, count, lefts, rights, stream, length);
+            return;
+        }
+#endif
+#ifdef MIXER_SSE2
+        mixSSE2(rows, stride, count, lefts, rights, stream, length);
+#else
+        mixScalar(rows, stride, count, lefts, rights, stream, 0, length);
+#endif
+    }
+};
+
+Audio::Mixer::Mixer(uint32_t period, size_t voiceCount) : period(period), voices(std::clamp<size_t>(voiceCount, 1, UINT16_MAX)), rows(voices.size() * Block), lefts(voices.size()), rights(voices.size()), pendingCount(0), rendered(0), offset(0), anchored(false), outputLatency(0.0), dropped(0), notes(0), stolen(0), tunes(0), peak(0), latencyTotal(0), latencyMax(0) {
+    active.reserve(voices.size());
+    idle.reserve(voices.size());
+
+    for (auto &track : tracks) {
+        track.head = 0;
+        track.count = 0;
+        track.next = 0;
+    }
+
+    for (size_t i = voices.size(); i > 0; i--)
+        idle.push_back(i - 1);
+
+    // Voices built together share a clock seed, spread them apart
+    seed(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+void Audio::Mixer::seed(uint32_t seed) {
+    for (size_t i = 0; i < voices.size(); i++)
+        voices[i].tone.seed(seed + (uint32_t)i * 0x9E3779B9u);
+}
+
+void Audio::Mixer::sound(uint32_t time, uint8_t channel, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    collect();
+
+    if (!commands.push({time, Common::FramePacer::Now(), channel, frequency, duration, waveForm, volume, attack, decay, sustain, release, pan}))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Audio::Mixer::play(uint32_t time, uint8_t channel, const std::shared_ptr<const Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    collect();
+
+    if (!sequence)
+        return;
+
+    if (!commands.push({time, Common::FramePacer::Now(), channel, 0.0f, 0, waveForm, volume, attack, decay, sustain, release, pan, delay, sequence}))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Audio::Mixer::pcm(uint32_t time, uint8_t channel, const std::shared_ptr<const Sample> &sample, float rate, uint8_t volume, uint8_t pan) {
+    collect();
+
+    if (!sample)
+        return;
+
+    Command command{time, Common::FramePacer::Now(), channel, rate, 0, 0, volume, 0, 0, 0, 0, pan};
+    command.sample = sample;
+
+    if (!commands.push(command))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Frees what the audio thread has finished with
+void Audio::Mixer::collect() {
+    std::shared_ptr<const void> object;
+
+    while (retired.pop(object)) {
+        object.reset();
+    }
+}
+
+// Maps emulated time to an output sample. The first command is anchored
+// one period ahead, the slack later frames need to land on time. Commands
+// more than a period late or a quarter second early, after a pause or
+// fast-forward, anchor again.
+uint64_t Audio::Mixer::schedule(uint32_t time) {
+    int64_t sample = (int64_t)time * FREQUENCY / 1000;
+    int64_t target = sample + offset;
+
+    if (!anchored || target + (int64_t)period < (int64_t)rendered || target > (int64_t)rendered + FREQUENCY / 4) {
+        offset = (int64_t)rendered + period - sample;
+        anchored = true;
+        target = sample + offset;
+    }
+
+    return std::max(target, (int64_t)rendered);
+}
+
+// Hands a due command to the voices, or its tune to the channel's track
+void Audio::Mixer::dispatch(Pending &event, int64_t now, int position) {
+    Command &command = event.command;
+
+    if (command.sequence) {
+        measure(command, now, position);
+        enqueue(command, event.sample);
+    } else if (command.sample) {
+        measure(command, now, position);
+        start(command, command.frequency, 0, command.volume, position);
+
+        // The voice holds its own reference now
+        retire(command.sample);
+    } else if (command.duration == 0) {
+        for (auto index : active) {
+            if (voices[index].channel == command.channel)
+                voices[index].tone.stop();
+        }
+
+        if (command.channel < tracks.size())
+            clear(tracks[command.channel]);
+    } else {
+        measure(command, now, position);
+        start(command, command.frequency, command.duration, command.volume, position);
+    }
+}
+
+void Audio::Mixer::start(const Command &command, float frequency, uint16_t duration, uint8_t volume, int position) {
+    uint16_t index;
+
+    if (!idle.empty()) {
+        index = idle.back();
+        idle.pop_back();
+        active.push_back(index);
+    } else {
+        // Steal the quietest voice, the oldest of those equally quiet
+        auto victim = std::min_element(active.begin(), active.end(), [this](uint16_t a, uint16_t b) {
+            float levelA = voices[a].tone.Level();
+            float levelB = voices[b].tone.Level();
+
+            return levelA < levelB || (levelA == levelB && voices[a].started < voices[b].started);
+        });
+
+        index = *victim;
+        stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Voice &voice = voices[index];
+
+    // Constant power pan, scaled so centre matches the old mono level
+    float angle = (float)command.pan / UINT8_MAX * (float)M_PI_2;
+
+    voice.channel = command.channel;
+    voice.left = std::cos(angle) * (float)M_SQRT2;
+    voice.right = std::sin(angle) * (float)M_SQRT2;
+    voice.started = rendered + position;
+
+    // A stolen voice may still hold its sample
+    retire(voice.sample);
+
+    if (command.sample) {
+        voice.sample = command.sample;
+        voice.tone.sample(voice.sample.get(), frequency, volume);
+    } else {
+        voice.tone.tone(frequency, duration, command.waveForm, volume, command.attack, command.decay, command.sustain, command.release);
+    }
+
+    if (active.size() > peak.load(std::memory_order_relaxed))
+        peak.store(active.size(), std::memory_order_relaxed);
+}
+
+void Audio::Mixer::measure(const Command &command, int64_t now, int position) {
+    // Waiting in the queue, then the samples ahead of it in this buffer,
+    // then the device's own buffering
+    double seconds = (now - command.issued) / 1000000000.0 + (double)position / FREQUENCY + outputLatency.load(std::memory_order_relaxed);
+    uint64_t micros = (uint64_t)std::max(0.0, seconds * 1000000.0);
+
+    notes.fetch_add(1, std::memory_order_relaxed);
+    latencyTotal.fetch_add(micros, std::memory_order_relaxed);
+
+    if (micros > latencyMax.load(std::memory_order_relaxed))
+        latencyMax.store(micros, std::memory_order_relaxed);
+}
+
+void Audio::Mixer::enqueue(Command &command, uint64_t sample) {
+    if (command.channel >= tracks.size()) {
+        retire(command.sequence);
+        return;
+    }
+
+    Track &track = tracks[command.channel];
+
+    if (track.count == MAX_TUNES) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        retire(command.sequence);
+        return;
+    }
+
+    Pending &tune = track.tunes[(track.head + track.count) % MAX_TUNES];
+    tune.sample = sample + command.delay;
+    tune.command = std::move(command);
+    track.count++;
+
+    tunes.fetch_add(1, std::memory_order_relaxed);
+
+    advance(track);
+}
+
+// Drops finished tunes from the front of the track, so the first one
+// always has a note still to start
+void Audio::Mixer::advance(Track &track) {
+    while (track.count && track.next >= track.tunes[track.head].command.sequence->Notes().size()) {
+        retire(track.tunes[track.head].command.sequence);
+        track.head = (track.head + 1) % MAX_TUNES;
+        track.count--;
+        track.next = 0;
+    }
+}
+
+void Audio::Mixer::clear(Track &track) {
+    while (track.count) {
+        retire(track.tunes[track.head].command.sequence);
+        track.head = (track.head + 1) % MAX_TUNES;
+        track.count--;
+    }
+
+    track.next = 0;
+}
+
+// Renders each sounding voice into its own row, then sums the rows into
+// the output in one pass. Voices that finish are returned to the pool.
+void Audio::Mixer::render(float *stream, int length) {
+    while (length > 0) {
+        int count = std::min(length, Block);
+
+        if (active.empty()) {
+            std::memset(stream, 0, sizeof(float) * 2 * count);
+        } else {
+            for (size_t v = 0; v < active.size(); v++) {
+                Voice &voice = voices[active[v]];
+                float *row = rows.data() + v * Block;
+
+                std::memset(row, 0, sizeof(float) * count);
+                voice.tone.generateSamples(row, count, 0.25);
+
+                lefts[v] = voice.left;
+                rights[v] = voice.right;
+            }
+
+            mixRows(rows.data(), Block, active.size(), lefts.data(), rights.data(), stream, count);
+
+            for (size_t v = 0; v < active.size();) {
+                if (voices[active[v]].tone.Playing()) {
+                    v++;
+                } else {
+                    retire(voices[active[v]].sample);
+                    idle.push_back(active[v]);
+                    active[v] = active.back();
+                    active.pop_back();
+                }
+            }
+        }
+
+        stream += 2 * count;
+        length -= count;
+    }
+}
+
+void Audio::Mixer::mix(float *stream, int frames) {
+    const int64_t now = Common::FramePacer::Now();
+    Command command;
+
+    // Commands arrive in time order, so pending stays sorted
+    while (pendingCount < MaxPending && commands.pop(command)) {
+        uint64_t sample = schedule(command.time);
+        pending[pendingCount++] = {sample, std::move(command)};
+    }
+
+    const uint64_t end = rendered + frames;
+    size_t next = 0;
+    int position = 0;
+
+    // Render up to the next command or tune note, start everything due
+    // there, and carry on
+    while (position < frames) {
+        uint64_t until = end;
+
+        if (next < pendingCount)
+            until = std::min(until, pending[next].sample);
+
+        for (const auto &track : tracks)
+            until = std::min(until, due(track));
+
+        if (until > rendered + position) {
+            render(stream + 2 * position, (int)(until - rendered) - position);
+            position = (int)(until - rendered);
+        }
+
+        while (next < pendingCount && pending[next].sample <= rendered + position) {
+            dispatch(pending[next], now, position);
+            next++;
+        }
+
+        for (auto &track : tracks) {
+            while (due(track) <= rendered + position) {
+                const Pending &tune = track.tunes[track.head];
+                const Sequence::Note &note = tune.command.sequence->Notes()[track.next++];
+
+                start(tune.command, note.frequency, note.duration, (uint8_t)(tune.command.volume * note.volume / UINT8_MAX), position);
+                advance(track);
+            }
+        }
+    }
+
+    std::move(pending.begin() + next, pending.begin() + pendingCount, pending.begin());
+    pendingCount -= next;
+
+    rendered = end;
+}
+
+std::string Audio::Mixer::report() const {
+    std::stringstream out;
+    uint64_t count = notes.load(std::memory_order_relaxed);
+
+    out << "Audio: " << period << " frame period, " << voices.size() << " voices";
+    out << " (peak " << peak.load(std::memory_order_relaxed) << ", " << stolen.load(std::memory_order_relaxed) << " stolen), ";
+    out << count << " notes, " << tunes.load(std::memory_order_relaxed) << " tunes";
+
+    if (count) {
+        out << std::fixed << std::setprecision(1);
+        out << ", latency " << latencyTotal.load(std::memory_order_relaxed) / 1000.0 / count << "ms avg";
+        out << " " << latencyMax.load(std::memory_order_relaxed) / 1000.0 << "ms max";
+    }
+
+    out << ", " << Dropped() << " dropped";
+
+    return out.str();
+}
+
+const char *Audio::MixKernel() {
+#ifdef MIXER_AVX2
+    if (hasAVX2())
+        return "avx2";
+#endif
+#ifdef MIXER_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,206 @@
+#ifndef __AUDIO_MIXER_H__
+#define __AUDIO_MIXER_H__
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <string>
+#include <memory>
+
+#include "Audio/Tone.h"
+#include "Audio/Sequence.h"
+#include "Audio/Sample.h"
+#include "Common/Shared.h"
+#include "Common/SPSCQueue.h"
+
+namespace Audio {
+    const size_t DEFAULT_VOICES = 32;
+
+    // Plays notes for a Sys backend from a fixed pool of voices, as
+    // interleaved stereo. sound() is called from the emulator thread and
+    // only queues a command, mix() runs on the audio thread and neither
+    // allocates nor takes a lock.
+    //
+    // Every note gets a voice of its own, so notes on the same channel
+    // overlap. When the pool is full the quietest voice is stolen. Only
+    // sounding voices are rendered, and all of them are summed into the
+    // output in a single pass.
+    //
+    // Commands carry the emulated time of the frame that issued them and
+    // start at the matching sample, a fixed delay after the first one, so
+    // notes keep their spacing however the periods fall.
+    //
+    // Tunes from play() are queued per channel and their notes started
+    // here on the audio thread, each on its exact sample. Samples from
+    // pcm() are read in place by the voices playing them. Finished tunes
+    // and samples are handed back to be freed by the next play(), pcm()
+    // or sound() call.
+    class Mixer {
+            struct Command {
+                uint32_t time;
+                int64_t issued;
+                uint8_t channel;
+                float frequency;
+                uint16_t duration;
+                uint8_t waveForm;
+                uint8_t volume;
+                uint8_t attack;
+                uint8_t decay;
+                uint8_t sustain;
+                uint8_t release;
+                uint8_t pan;
+
+                // Tunes only, samples after the command is due
+                uint32_t delay;
+                std::shared_ptr<const Sequence> sequence;
+
+                // PCM only, played at frequency samples a second
+                std::shared_ptr<const Sample> sample;
+            };
+
+            struct Pending {
+                uint64_t sample;
+                Command command;
+            };
+
+            // Tunes waiting or playing on one channel, sample is where
+            // each starts and next the note of the first one due next
+            struct Track {
+                std::array<Pending, MAX_TUNES> tunes;
+                size_t head;
+                size_t count;
+                size_t next;
+            };
+
+            struct Voice {
+                Tone tone;
+                std::shared_ptr<const Sample> sample;
+                uint8_t channel;
+                float left;
+                float right;
+                uint64_t started;
+            };
+
+            static constexpr size_t MaxPending = 256;
+
+            // Voices render this many samples at a time into their rows
+            static constexpr int Block = 256;
+
+            const uint32_t period;
+
+            Common::SPSCQueue<Command, 256> commands;
+
+            // Tunes and samples the audio thread is done with. Room for
+            // everything commands, pending, the tracks and a usual pool of
+            // voices can hold, should it still fill the object is freed
+            // in place.
+            Common::SPSCQueue<std::shared_ptr<const void>, 1024> retired;
+
+            // Audio thread only
+            std::vector<Voice> voices;
+            std::vector<uint16_t> active;
+            std::vector<uint16_t> idle;
+            std::vector<float> rows;
+            std::vector<float> lefts;
+            std::vector<float> rights;
+
+            std::array<Pending, MaxPending> pending;
+            size_t pendingCount;
+            std::array<Track, VOICE_COUNT> tracks;
+            uint64_t rendered;
+            int64_t offset;
+            bool anchored;
+
+            uint64_t schedule(uint32_t time);
+            void dispatch(Pending &event, int64_t now, int position);
+            void start(const Command &command, float frequency, uint16_t duration, uint8_t volume, int position);
+            void measure(const Command &command, int64_t now, int position);
+            void render(float *stream, int length);
+
+            void enqueue(Command &command, uint64_t sample);
+            void advance(Track &track);
+            void clear(Track &track);
+            void collect();
+
+            template <typename T> void retire(std::shared_ptr<T> &object) {
+                if (object)
+                    retired.push(object);
+
+                object.reset();
+            }
+
+            uint64_t due(const Track &track) const {
+                if (!track.count)
+                    return UINT64_MAX;
+
+                const Pending &tune = track.tunes[track.head];
+                return tune.sample + tune.command.sequence->Notes()[track.next].start;
+            }
+
+            std::atomic<double> outputLatency;
+            std::atomic<uint64_t> dropped;
+            std::atomic<uint64_t> notes;
+            std::atomic<uint64_t> stolen;
+            std::atomic<uint64_t> tunes;
+            std::atomic<uint64_t> peak;
+            std::atomic<uint64_t> latencyTotal;
+            std::atomic<uint64_t> latencyMax;
+        public:
+            // period is the device buffer size in frames, voiceCount the
+            // most notes that can sound at once
+            Mixer(uint32_t period, size_t voiceCount=DEFAULT_VOICES);
+
+            Mixer(const Mixer &) = delete;
+            Mixer &operator=(const Mixer &) = delete;
+
+            // time is the emulated milliseconds of the issuing frame. A
+            // duration of 0 silences every note on the channel. pan runs
+            // from 0 (left) through 128 (centre) to 255 (right).
+            void sound(uint32_t time, uint8_t channel, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan=128);
+
+            // Plays a whole tune on the channel, starting delay samples
+            // after time. Tunes on a channel should not overlap, the
+            // caller chains them. A sound() with duration 0 on the
+            // channel stops its tunes as well.
+            void play(uint32_t time, uint8_t channel, const std::shared_ptr<const Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan=128);
+
+            // Plays the sample on the channel at rate samples a second,
+            // until it ends or, when it loops, until the channel is
+            // silenced
+            void pcm(uint32_t time, uint8_t channel, const std::shared_ptr<const Sample> &sample, float rate, uint8_t volume, uint8_t pan=128);
+
+            // Writes frames stereo frames to stream, left then right
+            void mix(float *stream, int frames);
+
+            // Restarts every voice's noise generators, for repeatable output
+            void seed(uint32_t seed);
+
+            // Seconds between a sample leaving mix() and reaching the
+            // speaker, as the audio API reports it
+            void setOutputLatency(double seconds) {
+                outputLatency.store(seconds, std::memory_order_relaxed);
+            }
+
+            uint32_t Period() const {
+                return period;
+            }
+
+            size_t Voices() const {
+                return voices.size();
+            }
+
+            // Commands lost because the audio thread fell behind
+            uint64_t Dropped() const {
+                return dropped.load(std::memory_order_relaxed);
+            }
+
+            // Measured time from sound() to the note reaching the output
+            std::string report() const;
+    };
+
+    // Name of the kernel the mix pass dispatches to.
+    const char *MixKernel();
+}; // Audio
+
+#endif //__AUDIO_MIXER_H__
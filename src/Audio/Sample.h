@@ -0,0 +1,50 @@
+#ifndef __AUDIO_SAMPLE_H__
+#define __AUDIO_SAMPLE_H__
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace Audio {
+    // 16 bit PCM for PCM playback, with optional loop points. Built once
+    // from VM memory by SAMPLE and never changed after, every voice that
+    // plays it reads this same buffer.
+    class Sample {
+            std::vector<int16_t> data;
+            uint32_t loopStart;
+            uint32_t loopEnd;
+        public:
+            // A loop end past the start loops from loopStart up to just
+            // before loopEnd once the sample reaches it, anything else
+            // plays the sample once
+            Sample(std::vector<int16_t> pcm, uint32_t start=0, uint32_t end=0) : data(std::move(pcm)) {
+                loopEnd = std::min<uint32_t>(end, data.size());
+                loopStart = std::min(start, loopEnd);
+
+                if (loopStart == loopEnd)
+                    loopStart = loopEnd = 0;
+            }
+
+            const int16_t *Data() const {
+                return data.data();
+            }
+
+            uint32_t Length() const {
+                return data.size();
+            }
+
+            bool Looped() const {
+                return loopEnd > loopStart;
+            }
+
+            uint32_t LoopStart() const {
+                return loopStart;
+            }
+
+            uint32_t LoopEnd() const {
+                return loopEnd;
+            }
+    };
+}; // Audio
+
+#endif //__AUDIO_SAMPLE_H__
@@ -0,0 +1,198 @@
+#include <cmath>
+#include <cctype>
+#include <algorithm>
+
+#include "Audio/Sequence.h"
+
+namespace {
+    const int Octaves = 8;
+
+    // Semitones above C for A to G
+    const int Semitones[] = {9, 11, 0, 2, 4, 5, 7};
+
+    class Reader {
+            const std::string &mml;
+            size_t pos;
+
+            void skip() {
+                while (pos < mml.size() && std::isspace((unsigned char)mml[pos]))
+                    pos++;
+            }
+        public:
+            Reader(const std::string &mml) : mml(mml), pos(0) {
+            }
+
+            bool done() {
+                skip();
+                return pos >= mml.size();
+            }
+
+            char next() {
+                skip();
+                return pos < mml.size() ? std::toupper((unsigned char)mml[pos++]) : 0;
+            }
+
+            bool accept(char c) {
+                skip();
+
+                if (pos < mml.size() && std::toupper((unsigned char)mml[pos]) == c) {
+                    pos++;
+                    return true;
+                }
+
+                return false;
+            }
+
+            // -1 when no number follows
+            int number() {
+                skip();
+
+                if (pos >= mml.size() || !std::isdigit((unsigned char)mml[pos]))
+                    return -1;
+
+                int value = 0;
+
+                while (pos < mml.size() && std::isdigit((unsigned char)mml[pos])) {
+                    value = std::min(value * 10 + (mml[pos] - '0'), 100000);
+                    pos++;
+                }
+
+                return value;
+            }
+
+            int dots() {
+                int count = 0;
+
+                while (accept('.'))
+                    count++;
+
+                return count;
+            }
+    };
+
+    double frequency(int semitone) {
+        // A of octave 4 is 440Hz
+        return 440.0 * std::pow(2.0, (semitone - 57) / 12.0);
+    }
+};
+
+Audio::Sequence::Sequence(const std::string &mml) : length(0) {
+    Reader reader(mml);
+
+    int octave = 4;
+    int noteLength = 4;
+    int tempo = 120;
+    int volume = 15;
+    double articulation = 7.0 / 8.0;
+
+    // Kept in seconds so rounding never accumulates
+    double position = 0.0;
+
+    auto seconds = [&](int length, int dots) {
+        double duration = 240.0 / ((double)tempo * length);
+        double extra = duration;
+
+        for (int i = 0; i < dots; i++) {
+            extra /= 2.0;
+            duration += extra;
+        }
+
+        return duration;
+    };
+
+    auto play = [&](int semitone, double duration) {
+        uint32_t start = (uint32_t)std::llround(position * FREQUENCY);
+        double sounding = std::min(duration * articulation, 65.535);
+
+        if (volume > 0 && semitone >= 0 && semitone < Octaves * 12) {
+            notes.push_back({start, (float)frequency(semitone), (uint16_t)std::llround(sounding * 1000.0), (uint8_t)(volume * 17)});
+        }
+
+        position += duration;
+    };
+
+    while (!reader.done()) {
+        char command = reader.next();
+
+        switch (command) {
+            case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': {
+                    int semitone = octave * 12 + Semitones[command - 'A'];
+
+                    if (reader.accept('#') || reader.accept('+'))
+                        semitone++;
+                    else if (reader.accept('-'))
+                        semitone--;
+
+                    int length = reader.number();
+                    if (length < 1 || length > 64)
+                        length = noteLength;
+
+                    play(semitone, seconds(length, reader.dots()));
+                }
+                break;
+            case 'N': {
+                    int number = reader.number();
+                    double duration = seconds(noteLength, reader.dots());
+
+                    if (number == 0)
+                        position += duration;
+                    else if (number > 0 && number <= Octaves * 12)
+                        play(number - 1, duration);
+                }
+                break;
+            case 'P':
+            case 'R': {
+                    int length = reader.number();
+                    if (length < 1 || length > 64)
+                        length = noteLength;
+
+                    position += seconds(length, reader.dots());
+                }
+                break;
+            case 'O': {
+                    int value = reader.number();
+                    if (value >= 0 && value < Octaves)
+                        octave = value;
+                }
+                break;
+            case '>':
+                octave = std::min(octave + 1, Octaves - 1);
+                break;
+            case '<':
+                octave = std::max(octave - 1, 0);
+                break;
+            case 'L': {
+                    int value = reader.number();
+                    if (value >= 1 && value <= 64)
+                        noteLength = value;
+                }
+                break;
+            case 'T': {
+                    int value = reader.number();
+                    if (value >= 32 && value <= 255)
+                        tempo = value;
+                }
+                break;
+            case 'V': {
+                    int value = reader.number();
+                    if (value >= 0 && value <= 15)
+                        volume = value;
+                }
+                break;
+            case 'M':
+                if (reader.accept('N'))
+                    articulation = 7.0 / 8.0;
+                else if (reader.accept('L'))
+                    articulation = 1.0;
+                else if (reader.accept('S'))
+                    articulation = 3.0 / 4.0;
+                else if (!reader.accept('F'))
+                    reader.accept('B');
+                break;
+            default:
+                break;
+        }
+    }
+
+    length = (uint32_t)std::llround(position * FREQUENCY);
+}
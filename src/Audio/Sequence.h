@@ -0,0 +1,61 @@
+#ifndef __AUDIO_SEQUENCE_H__
+#define __AUDIO_SEQUENCE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Audio/Tone.h"
+
+namespace Audio {
+    // Tunes a channel can have queued, playing one included
+    const size_t MAX_TUNES = 16;
+
+    // A tune written in the music macro language of PLAY, turned into
+    // notes with sample exact start times. Parsed once on the emulation
+    // thread and then only read, so it can be shared with the mixers.
+    //
+    //   A to G    note, followed by # or + for sharp, - for flat, an
+    //             optional length and any number of dots
+    //   N n       note number n, 1 to 96 counting semitones up from
+    //             the C of octave 0, 0 is a rest
+    //   P n, R n  rest of length n
+    //   O n       octave 0 to 7, > and < step up and down one
+    //   L n       default length, 1 whole, 4 quarter, up to 64
+    //   T n       tempo in quarter notes per minute, 32 to 255
+    //   V n       volume 0 to 15
+    //   MN ML MS  normal, legato and staccato, notes sound for 7/8, all
+    //             or 3/4 of their length
+    //   MF MB     accepted for compatibility, tunes always play in the
+    //             background
+    //
+    // Anything else is skipped, as are values out of range.
+    class Sequence {
+        public:
+            struct Note {
+                // Samples from the start of the tune
+                uint32_t start;
+                float frequency;
+                uint16_t duration;
+                uint8_t volume;
+            };
+        private:
+            std::vector<Note> notes;
+            uint32_t length;
+        public:
+            Sequence(const std::string &mml);
+
+            const std::vector<Note> &Notes() const {
+                return notes;
+            }
+
+            // Samples from the start of the tune to the end of its last
+            // note or rest
+            uint32_t Length() const {
+                return length;
+            }
+    };
+}; // Audio
+
+#endif //__AUDIO_SEQUENCE_H__
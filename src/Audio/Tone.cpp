@@ -1,213 +1,405 @@
-#ifdef _WIN32
-#include "mingw.thread.h"
-#else
-#include <thread>
-#endif
-
 #include <cmath>
-#include <random>
 #include <array>
+#include <vector>
+#include <chrono>
 #include <iostream>
+#include <algorithm>
 
 #include "Audio/Tone.h"
 #include "Common/Shared.h"
 
-#define PINK_MAX_RANDOM_ROWS   (30)
-#define PINK_RANDOM_BITS       (24)
-#define PINK_RANDOM_SHIFT      ((sizeof(int32_t)*8)-PINK_RANDOM_BITS)
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(__EMSCRIPTEN__)
+#define TONE_AVX2 1
+#include <immintrin.h>
+#endif
 
-static double fRand(double fMin, double fMax) {
-    double f = (double)rand() / RAND_MAX;
-    return fMin + f * (fMax - fMin);
-}
+#if defined(__SSE2__) || defined(TONE_AVX2)
+#define TONE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Tables hold one cycle, indexed by the top TableBits of the phase,
+    // with a guard sample so interpolation never wraps.
+    const int TableBits = 11;
+    const int TableSize = 1 << TableBits;
+    const int FractionBits = 32 - TableBits;
+    const float FractionScale = 1.0f / (float)(1 << FractionBits);
+
+    // Level n holds the harmonics up to 2^n, enough for every frequency
+    // whose 2^n-th harmonic is still below Nyquist.
+    const int Levels = TableBits;
+
+    typedef std::array<float, TableSize + 1> Table;
+
+    class Wavetables {
+            std::vector<Table> tables;
+
+            static int slot(uint8_t waveForm) {
+                switch (waveForm) {
+                    case Common::WaveForm::SAWTOOTH:
+                        return 1;
+                    case Common::WaveForm::TRIANGLE:
+                        return 2;
+                    case Common::WaveForm::SQUARE:
+                        return 3;
+                    case Common::WaveForm::SINE:
+                    default:
+                        return 0;
+                }
+            }
+        public:
+            Wavetables() : tables(1 + 3 * Levels) {
+                Table &sine = tables[0];
+
+                for (int i = 0; i <= TableSize; i++)
+                    sine[i] = std::sin(2.0 * M_PI * i / TableSize);
+
+                // Additive synthesis of the same shapes the oscillator has
+                // always produced: a rising ramp, a triangle starting at -1
+                // and a square in phase with the sine. Each level starts
+                // from the one below and adds the next octave of harmonics.
+                for (int shape = 1; shape <= 3; shape++) {
+                    std::vector<double> sum(TableSize, 0.0);
+                    int harmonic = 1;
+
+                    for (int level = 0; level < Levels; level++) {
+                        for (; harmonic <= (1 << level); harmonic++) {
+                            double gain = 0.0;
+                            int offset = 0;
+
+                            if (shape == 1) {
+                                gain = -2.0 / (M_PI * harmonic);
+                            } else if (harmonic & 1) {
+                                if (shape == 2) {
+                                    gain = -8.0 / (M_PI * M_PI * harmonic * harmonic);
+                                    offset = TableSize / 4;
+                                } else {
+                                    gain = 4.0 / (M_PI * harmonic);
+                                }
+                            }
+
+                            if (gain == 0.0)
+                                continue;
+
+                            for (int i = 0; i < TableSize; i++)
+                                sum[i] += gain * sine[((size_t)harmonic * i + offset) & (TableSize - 1)];
+                        }
+
+                        Table &table = tables[1 + (shape - 1) * Levels + level];
+
+                        for (int i = 0; i < TableSize; i++)
+                            table[i] = (float)sum[i];
+
+                        table[TableSize] = table[0];
+                    }
+                }
+            }
 
-class PinkNoise {
-    private:
-        std::array<int32_t, PINK_MAX_RANDOM_ROWS> rows;
-        int32_t runningSum;     // Used to optimize summing of generators
-        int32_t index;          // Incremented each sample
-        int32_t indexMask;      // Index wrapped by ANDing with this mask
-        float scalar;           // Used to scale within range of -1.0 to +1.0
-        uint32_t seed;
-
-        uint32_t generateRandomNumber() {
-            static uint32_t randSeed = seed;
-            randSeed = (randSeed * 196314165) + 907633515;
-            return randSeed;
+            const float *lookup(uint8_t waveForm, uint32_t increment) const {
+                int s = slot(waveForm);
+
+                if (s == 0)
+                    return tables[0].data();
+
+                // Harmonics below Nyquist: 2^31 / increment
+                uint32_t harmonics = increment ? (uint32_t)(0x80000000u / increment) : 0xFFFFFFFFu;
+                int level = harmonics ? std::min(Levels - 1, 31 - __builtin_clz(harmonics)) : 0;
+
+                return tables[1 + (s - 1) * Levels + level].data();
+            }
+    };
+
+    const Wavetables &wavetables() {
+        static const Wavetables tables;
+        return tables;
+    }
+
+    // Every kernel adds count samples of table, scaled by a gain ramp
+    // starting at gain, into stream. Returns the advanced phase.
+    uint32_t renderScalar(const float *table, uint32_t phase, uint32_t increment, float gain, float step, float *stream, int count) {
+        for (int i = 0; i < count; i++) {
+            uint32_t index = phase >> FractionBits;
+            float fraction = (float)(phase & ((1u << FractionBits) - 1)) * FractionScale;
+            float a = table[index];
+
+            stream[i] += (a + (table[index + 1] - a) * fraction) * gain;
+
+            gain += step;
+            phase += increment;
         }
-    public:
-        PinkNoise(int numRows) {
-            numRows = std::min(PINK_MAX_RANDOM_ROWS, numRows);
 
-            seed = std::chrono::system_clock::now().time_since_epoch().count();
-            index = 0;
-            indexMask = (1<<numRows) - 1;
+        return phase;
+    }
+
+#ifdef TONE_SSE2
+    uint32_t renderSSE2(const float *table, uint32_t phase, uint32_t increment, float gain, float step, float *stream, int count) {
+        const __m128i lanes = _mm_setr_epi32(0, (int)increment, (int)(2 * increment), (int)(3 * increment));
+        const __m128i mask = _mm_set1_epi32((1 << FractionBits) - 1);
+        const __m128 scale = _mm_set1_ps(FractionScale);
+        const __m128 gainStep = _mm_set1_ps(4 * step);
 
-            // Calculate maximum possible signed random value. Extra 1 for white noise always added.
-            int32_t pmax = (numRows + 1) * (1<<(PINK_RANDOM_BITS-1));
-            scalar = 1.0f / pmax;
+        __m128 gains = _mm_setr_ps(gain, gain + step, gain + 2 * step, gain + 3 * step);
+        int i = 0;
 
-            rows.fill(0);
-            runningSum = 0;
+        // Four phases at once, the table reads stay scalar as SSE2 has
+        // no gather.
+        for (; i + 4 <= count; i += 4) {
+            __m128i phases = _mm_add_epi32(_mm_set1_epi32((int)phase), lanes);
+            __m128 fraction = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(phases, mask)), scale);
+
+            alignas(16) uint32_t index[4];
+            _mm_store_si128((__m128i *)index, _mm_srli_epi32(phases, FractionBits));
+
+            __m128 a = _mm_setr_ps(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+            __m128 b = _mm_setr_ps(table[index[0] + 1], table[index[1] + 1], table[index[2] + 1], table[index[3] + 1]);
+            __m128 sample = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction));
+
+            _mm_storeu_ps(stream + i, _mm_add_ps(_mm_loadu_ps(stream + i), _mm_mul_ps(sample, gains)));
+
+            gains = _mm_add_ps(gains, gainStep);
+            phase += 4 * increment;
         }
 
-        float generate() {
-            int32_t newRandom;
-            int32_t sum;
-            float output;
-
-            // Increment and mask index
-            index = (index + 1) & indexMask;
-
-            // If index is zero, don't update any random values.
-            if (index != 0) {
-                // Determine how many trailing zeros in PinkIndex.
-                // This algorithm will hang if n==0 so test first.
-                int numZeros = 0;
-                int n = index;
-                while((n & 1) == 0) {
-                    n = n >> 1;
-                    numZeros++;
-                }
-                // Replace the indexed ROWS random value.
-                // Subtract and add back to RunningSum instead of adding all the random
-                // values together. Only one changes each time.
-                runningSum -= rows[numZeros];
-                newRandom = ((int32_t)generateRandomNumber()) >> PINK_RANDOM_SHIFT;
-                runningSum += newRandom;
-                rows[numZeros] = newRandom;
-            }
+        return renderScalar(table, phase, increment, gain + step * i, step, stream + i, count - i);
+    }
+#endif
+
+#ifdef TONE_AVX2
+    __attribute__((target("avx2")))
+    uint32_t renderAVX2(const float *table, uint32_t phase, uint32_t increment, float gain, float step, float *stream, int count) {
+        const __m256i lanes = _mm256_mullo_epi32(_mm256_set1_epi32((int)increment), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        const __m256i mask = _mm256_set1_epi32((1 << FractionBits) - 1);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 scale = _mm256_set1_ps(FractionScale);
+        const __m256 gainStep = _mm256_set1_ps(8 * step);
+
+        __m256 gains = _mm256_add_ps(_mm256_set1_ps(gain), _mm256_mul_ps(_mm256_set1_ps(step), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)));
+        int i = 0;
+
+        // Eight phases at once with both interpolation points gathered.
+        for (; i + 8 <= count; i += 8) {
+            __m256i phases = _mm256_add_epi32(_mm256_set1_epi32((int)phase), lanes);
+            __m256i index = _mm256_srli_epi32(phases, FractionBits);
+            __m256 fraction = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(phases, mask)), scale);
 
-            // Add extra white noise value.
-            newRandom = ((int32_t)generateRandomNumber()) >> PINK_RANDOM_SHIFT;
-            sum = runningSum + newRandom;
-            // Scale to range of -1.0 to 0.9999.
-            output = scalar * sum;
+            __m256 a = _mm256_i32gather_ps(table, index, 4);
+            __m256 b = _mm256_i32gather_ps(table, _mm256_add_epi32(index, one), 4);
+            __m256 sample = _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), fraction));
 
-            return output;
+            _mm256_storeu_ps(stream + i, _mm256_add_ps(_mm256_loadu_ps(stream + i), _mm256_mul_ps(sample, gains)));
+
+            gains = _mm256_add_ps(gains, gainStep);
+            phase += 8 * increment;
         }
+
+        return renderScalar(table, phase, increment, gain + step * i, step, stream + i, count - i);
+    }
+
+    bool hasAVX2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#endif
+
+    uint32_t renderWavetable(const float *table, uint32_t phase, uint32_t increment, float gain, float step, float *stream, int count) {
+#ifdef TONE_AVX2
+        if (hasAVX2())
+            return renderAVX2(table, phase, increment, gain, step, stream, count);
+#endif
+#ifdef TONE_SSE2
+        return renderSSE2(table, phase, increment, gain, step, stream, count);
+#else
+        return renderScalar(table, phase, increment, gain, step, stream, count);
+#endif
+    }
 };
 
-Audio::Tone::Tone() {
-    v = 0.0;
+Audio::PinkNoise::PinkNoise(int numRows, uint32_t seed) {
+    numRows = std::min(MaxRows, numRows);
+    indexMask = (1<<numRows) - 1;
+
+    // Maximum possible signed random value, the extra 1 is for the white
+    // noise always added.
+    int32_t pmax = (numRows + 1) * (1<<(RandomBits-1));
+    scalar = 1.0f / pmax;
+
+    this->seed(seed);
+}
+
+void Audio::PinkNoise::seed(uint32_t seed) {
+    state = seed;
+    index = 0;
+    rows.fill(0);
+    runningSum = 0;
+}
+
+Audio::Tone::Tone() : phase(0), playing(false), pcm(nullptr), position(0), step(0), noiseValue(0.0f) {
+    seed(std::chrono::system_clock::now().time_since_epoch().count());
+
+    // Build the tables now rather than in the first audio callback
+    wavetables();
+}
+
+void Audio::Tone::seed(uint32_t seed) {
+    // xorshift must never be zero
+    noiseState = seed ? seed : 0x9E3779B9u;
+    pinknoise.seed(seed);
 }
 
 void Audio::Tone::tone(float freq, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
-    ToneObject to;
-    to.freq = (double)freq;
-    to.samplesLeft = duration * FREQUENCY / 1000;
+    ToneObject &to = current;
+
+    pcm = nullptr;
+
+    // Anything at or above Nyquist would only alias
+    double cycles = std::min(std::max((double)freq, 0.0) / FREQUENCY, 0.5);
+
+    to.increment = (uint32_t)std::min(cycles * 4294967296.0, 2147483647.0);
+    to.samplesLeft = (int)((int64_t)duration * FREQUENCY / 1000);
     to.waveForm = waveForm;
     to.volume = (float)volume/(float)UINT8_MAX;
+    to.segment = 0;
 
+    // Envelope times are in tenths of a percent of the tone length
     const int Scale = to.samplesLeft / (10 * FREQUENCY / 1000);
 
-    to.sustainLevel = (float)sustain/(float)UINT8_MAX;
+    const float sustainLevel = (float)sustain/(float)UINT8_MAX;
+    const int attackLength = attack * Scale;
+    const int decayLength = sustain == 255 ? 0 : decay * Scale;
+    const int releaseLength = release * Scale;
+    const int sustainLength = std::max(0, to.samplesLeft - attackLength - decayLength - releaseLength);
+
+    to.envelope[0] = {attackLength, 0.0f, attackLength ? 1.0f / attackLength : 0.0f};
+    to.envelope[1] = {decayLength, 1.0f, decayLength ? -(1.0f - sustainLevel) / decayLength : 0.0f};
+    to.envelope[2] = {sustainLength, sustainLevel, 0.0f};
+    to.envelope[3] = {releaseLength, sustainLevel, releaseLength ? -sustainLevel / releaseLength : 0.0f};
+
+    while (to.segment < to.envelope.size() && to.envelope[to.segment].length == 0)
+        to.segment++;
+
+    playing = to.samplesLeft > 0;
+}
+
+// Renders count samples that all fall inside the current envelope segment.
+void Audio::Tone::render(float *stream, int count, float amplitude) {
+    ToneObject &to = current;
+    EnvelopeSegment &segment = to.envelope[to.segment];
+
+    float scale = to.volume * amplitude;
+    float gain = segment.level * scale;
+    float step = segment.step * scale;
 
-    to.attackLeft = attack*Scale;
-    to.attackStep = ((float)UINT8_MAX/(float)attack)/UINT8_MAX/Scale;
+    switch (to.waveForm) {
+        case Common::WaveForm::NOISE:
+            for (int i = 0; i < count; i++) {
+                uint32_t next = phase + to.increment;
 
-    if (sustain == 255) {
-        to.decayLeft = 0;
-    } else {
-        to.decayLeft = decay*Scale;
-        to.decayStep = (1.0-to.sustainLevel) * ((float)(UINT8_MAX)/(float)decay)/UINT8_MAX/Scale;
+                if (next < phase)
+                    noiseValue = nextNoise();
+
+                phase = next;
+                stream[i] += noiseValue * gain;
+                gain += step;
+            }
+            break;
+        case Common::WaveForm::PINKNOISE:
+            for (int i = 0; i < count; i++) {
+                stream[i] += pinknoise.generate() * gain;
+                gain += step;
+            }
+            break;
+        default:
+            phase = renderWavetable(wavetables().lookup(to.waveForm, to.increment), phase, to.increment, gain, step, stream, count);
     }
 
-    to.releaseLeft = release * Scale;
-    to.releaseStep = to.sustainLevel * ((float)(UINT8_MAX)/(float)release)/UINT8_MAX/Scale;
+    segment.level += segment.step * count;
+    segment.length -= count;
+}
+
+void Audio::Tone::sample(const Sample *sample, float rate, uint8_t volume) {
+    pcm = sample;
+    position = 0;
+    step = (uint64_t)(std::max((double)rate, 0.0) / FREQUENCY * 4294967296.0);
+    current.volume = (float)volume/(float)UINT8_MAX;
 
-    to.sustainLeft = to.samplesLeft - to.attackLeft - to.decayLeft - to.releaseLeft;
+    playing = sample->Length() > 0;
+}
 
-    tones.push(to);
+// Linear interpolation between neighbouring samples, wrapping back to the
+// loop start once past the loop end.
+void Audio::Tone::renderSample(float *stream, int length, float amplitude) {
+    const int16_t *data = pcm->Data();
+    const bool looped = pcm->Looped();
+    const uint32_t last = looped ? pcm->LoopEnd() : pcm->Length();
+    const uint64_t end = (uint64_t)last << 32;
+    const uint64_t start = (uint64_t)pcm->LoopStart() << 32;
+    const float scale = current.volume * amplitude / 32768.0f;
+
+    for (int i = 0; i < length; i++) {
+        if (position >= end) {
+            if (!looped) {
+                playing = false;
+                return;
+            }
 
-#if 0
-    std::cerr << (to.attackLeft * to.attackStep) << "," << (0 * to.attackStep) << std::endl;
-    std::cerr << (to.decayLeft * to.decayStep) + to.sustainLevel << "," << (0 * to.decayStep) + to.sustainLevel << std::endl;
-    std::cerr << to.sustainLevel << "," << to.sustainLeft << std::endl;
-    std::cerr << (to.releaseLeft * to.releaseStep) << "," << (0 * to.releaseStep) << std::endl;
-#endif
+            position = start + (position - end) % (end - start);
+        }
+
+        uint32_t index = position >> 32;
+        float fraction = (float)(uint32_t)position * (1.0f / 4294967296.0f);
+        float sample = data[index];
+        float next = index + 1 < last ? data[index + 1] : (looped ? data[pcm->LoopStart()] : 0.0f);
+
+        stream[i] += (sample + (next - sample) * fraction) * scale;
+        position += step;
+    }
 }
 
 void Audio::Tone::generateSamples(float *stream, int length, float amplitude) {
-    static PinkNoise pinknoise(16);
     int i = 0;
 
-    std::array<float, 32> noise;
+    if (pcm) {
+        if (playing)
+            renderSample(stream, length, amplitude);
 
-    for (size_t i = 0; i < noise.size(); i++) {
-        noise[i] = fRand(-1.0, 1);
+        return;
     }
 
-    while (i < length) {
-        if (tones.empty()) {
-            while (i < length) {
-                stream[i] += 0;
-                i++;
-            }
-            return;
-        }
-        ToneObject& to = tones.front();
-
-        int samplesToDo = std::min(i + to.samplesLeft, length);
-        to.samplesLeft -= samplesToDo - i;
-
-        while (i < samplesToDo) {
-            float attack = 1.0f;
-            float decay = 1.0f;
-            float sustain = 1.0f;
-            float release = 1.0f;
-
-            if (to.attackLeft >= 0) {
-                attack -= (to.attackLeft * to.attackStep);
-                to.attackLeft--;
-            } else if (to.decayLeft >= 0) {
-                decay = (to.decayLeft * to.decayStep) + to.sustainLevel;
-                to.decayLeft--;
-            } else if (to.sustainLeft >= 0) {
-                sustain = to.sustainLevel;
-                to.sustainLeft--;
-            } else if (to.releaseLeft >= 0) {
-                release = (to.releaseLeft * to.releaseStep);
-                to.releaseLeft--;
-            }
+    while (i < length && playing) {
+        ToneObject& to = current;
 
-            float pos = std::fmod(v/FREQUENCY,1.0);
-            v += to.freq;
-
-            switch (to.waveForm) {
-                case Common::WaveForm::SAWTOOTH:
-                    stream[i] += attack * decay * sustain * release * to.volume * amplitude * (pos*2 - 1);
-                    break;
-                case Common::WaveForm::TRIANGLE:
-                    stream[i] += attack * decay * sustain * release * to.volume * amplitude * (1-std::fabs(pos-0.5)*4);
-                    break;
-                case Common::WaveForm::SQUARE:
-                    stream[i] += attack * decay * sustain * release * to.volume * amplitude * (std::sin(pos*2*M_PI) >= 0 ? 1.0 : -1.0);
-                    break;
-                case Common::WaveForm::NOISE:
-                    stream[i] += attack * decay * sustain * release * to.volume * amplitude * (noise[(int)(std::fmod(v/FREQUENCY,noise.size()))]);
-                    break;
-                case Common::WaveForm::PINKNOISE:
-                    stream[i] += attack * decay * sustain * release * to.volume * amplitude * (pinknoise.generate());
-                    break;
-                case Common::WaveForm::SINE:
-                default:
-                    stream[i] += attack * decay * sustain * release * to.volume * amplitude * (std::sin(pos*2*M_PI));
-            }
-            i++;
+        while (to.segment < to.envelope.size() && to.envelope[to.segment].length == 0)
+            to.segment++;
+
+        // Past the release nothing is left to play
+        if (to.segment == to.envelope.size())
+            to.samplesLeft = 0;
+
+        // The envelope is evaluated once per block, where a block runs
+        // to the end of the buffer, the tone or the envelope segment.
+        int count = std::min({length - i, to.samplesLeft, to.segment < to.envelope.size() ? to.envelope[to.segment].length : 0});
+
+        if (count > 0) {
+            render(stream + i, count, amplitude);
+            to.samplesLeft -= count;
+            i += count;
         }
 
         if (to.samplesLeft == 0) {
-            tones.pop();
+            playing = false;
         }
     }
 }
 
-void Audio::Tone::wait() {
-    size_t size;
-    do {
-        std::this_thread::sleep_for(std::chrono::milliseconds(20));
-        size = tones.size();
-    } while (size > 0);
+const char *Audio::OscillatorKernel() {
+#ifdef TONE_AVX2
+    if (hasAVX2())
+        return "avx2";
+#endif
+#ifdef TONE_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
 }
-
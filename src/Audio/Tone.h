@@ -2,43 +2,135 @@
 #define __AUDIO_TONE_H__
 
 #include <cstdint>
-#include <queue>
+#include <array>
 
 #include "Common/WaveForm.h"
+#include "Audio/Sample.h"
 
 namespace Audio {
     const int FREQUENCY = 44100;
 
+    // One straight line of the ADSR envelope, gain starts at level and
+    // moves by step each sample for length samples.
+    struct EnvelopeSegment {
+        int length;
+        float level;
+        float step;
+    };
+
     struct ToneObject {
-        double freq;
+        uint32_t increment;
         int samplesLeft;
         uint8_t waveForm;
         float volume;
 
-        int attackLeft;
-        float attackStep;
+        // Attack, decay, sustain and release, then silence
+        std::array<EnvelopeSegment, 4> envelope;
+        uint8_t segment;
+    };
+
+    // Voss-McCartney pink noise, with its own seedable generator so
+    // voices do not share state.
+    class PinkNoise {
+        private:
+            static constexpr int MaxRows = 30;
+            static constexpr int RandomBits = 24;
+
+            std::array<int32_t, MaxRows> rows;
+            int32_t runningSum;
+            int32_t index;
+            int32_t indexMask;
+            float scalar;
+            uint32_t state;
+
+            int32_t random() {
+                state = (state * 196314165) + 907633515;
+                return ((int32_t)state) >> (32 - RandomBits);
+            }
+        public:
+            PinkNoise(int numRows=16, uint32_t seed=0);
+            void seed(uint32_t seed);
 
-        int decayLeft;
-        float decayStep;
+            float generate() {
+                index = (index + 1) & indexMask;
 
-        int sustainLeft;
-        float sustainLevel;
+                // Update one row per sample, picked by the trailing zeros
+                // of the index, plus a white noise value every sample.
+                if (index != 0) {
+                    int row = __builtin_ctz(index);
+                    runningSum -= rows[row];
+                    rows[row] = random();
+                    runningSum += rows[row];
+                }
 
-        int releaseLeft;
-        float releaseStep;
+                return scalar * (runningSum + random());
+            }
     };
 
+    // One note at a time: starting a tone replaces whatever was playing.
+    // Audio::Mixer keeps a pool of these for polyphony.
     class Tone {
         private:
-            double v;
-            std::queue<ToneObject> tones;
+            uint32_t phase;
+            ToneObject current;
+            bool playing;
+
+            // Set while playing a sample instead of a waveform, the
+            // caller keeps it alive. Position and step are 32.32 fixed
+            // point sample indexes.
+            const Sample *pcm;
+            uint64_t position;
+            uint64_t step;
+
+            // NOISE holds a random value for each cycle of the tone
+            uint32_t noiseState;
+            float noiseValue;
+            PinkNoise pinknoise;
+
+            float nextNoise() {
+                noiseState ^= noiseState << 13;
+                noiseState ^= noiseState >> 17;
+                noiseState ^= noiseState << 5;
+                return (float)(int32_t)noiseState * (1.0f / 2147483648.0f);
+            }
+
+            void render(float *stream, int count, float amplitude);
+            void renderSample(float *stream, int length, float amplitude);
         public:
             Tone();
             ~Tone() {}
             void tone(float freq, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release);
+
+            // Plays the sample at rate samples a second, until it ends or,
+            // if it loops, is stopped
+            void sample(const Sample *sample, float rate, uint8_t volume);
+
+            // Adds up to length samples into stream, less once the tone ends
             void generateSamples(float *stream, int length, float amplitude=1.0f);
-            void wait();
+
+            void stop() {
+                playing = false;
+            }
+
+            bool Playing() const {
+                return playing;
+            }
+
+            // Current envelope gain times volume, for picking a voice to steal
+            float Level() const {
+                if (playing && pcm)
+                    return current.volume;
+
+                return playing && current.segment < current.envelope.size() ? current.envelope[current.segment].level * current.volume : 0.0f;
+            }
+
+            // Restarts the noise generators, the same seed gives the
+            // same samples.
+            void seed(uint32_t seed);
     };
+
+    // Name of the kernel the wavetable oscillator dispatches to.
+    const char *OscillatorKernel();
 }; // Audio
 
 #endif //__AUDIO_TONE_H__
@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "Audio/WAVFile.h"
+#include "Audio/Tone.h"
+
+namespace {
+    void writeLittleEndian(std::ostream &out, uint32_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++)
+            out.put((char)((value >> (i * 8)) & 0xFF));
+    }
+};
+
+Audio::WAVFile::WAVFile() : frames(0) {
+}
+
+Audio::WAVFile::~WAVFile() {
+    close();
+}
+
+bool Audio::WAVFile::open(const std::string &filename) {
+    out.open(filename, std::ios_base::binary);
+
+    if (!out.is_open())
+        return false;
+
+    frames = 0;
+    writeHeader();
+
+    return true;
+}
+
+void Audio::WAVFile::writeHeader() {
+    const uint32_t bytes = (uint32_t)(frames * 2 * sizeof(int16_t));
+
+    out.write("RIFF", 4);
+    writeLittleEndian(out, 36 + bytes, 4);
+    out.write("WAVEfmt ", 8);
+    writeLittleEndian(out, 16, 4);
+    writeLittleEndian(out, 1, 2);       // PCM
+    writeLittleEndian(out, 2, 2);       // stereo
+    writeLittleEndian(out, FREQUENCY, 4);
+    writeLittleEndian(out, FREQUENCY * 2 * sizeof(int16_t), 4);
+    writeLittleEndian(out, 2 * sizeof(int16_t), 2);
+    writeLittleEndian(out, 16, 2);
+    out.write("data", 4);
+    writeLittleEndian(out, bytes, 4);
+}
+
+void Audio::WAVFile::write(const int16_t *samples, size_t count) {
+    // Samples are already little endian on every platform we build for
+    out.write((const char *)samples, count * 2 * sizeof(int16_t));
+    frames += count;
+}
+
+void Audio::WAVFile::close() {
+    if (!out.is_open())
+        return;
+
+    out.seekp(0);
+    writeHeader();
+    out.close();
+}
+
+void Audio::ToPCM16(const float *samples, int16_t *pcm, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        pcm[i] = (int16_t)std::clamp(samples[i] * 32767.0f, -32768.0f, 32767.0f);
+}
@@ -0,0 +1,37 @@
+#ifndef __AUDIO_WAVFILE_H__
+#define __AUDIO_WAVFILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <fstream>
+
+namespace Audio {
+    // Writes 16 bit stereo PCM at Audio::FREQUENCY. The sizes in the
+    // header are filled in by close().
+    class WAVFile {
+            std::ofstream out;
+            uint64_t frames;
+
+            void writeHeader();
+        public:
+            WAVFile();
+            ~WAVFile();
+
+            bool open(const std::string &filename);
+
+            bool isOpen() const {
+                return out.is_open();
+            }
+
+            // frames stereo frames, left then right
+            void write(const int16_t *samples, size_t frames);
+
+            void close();
+    };
+
+    // Clamps count float samples in -1..1 to 16 bit
+    void ToPCM16(const float *samples, int16_t *pcm, size_t count);
+}; // Audio
+
+#endif //__AUDIO_WAVFILE_H__
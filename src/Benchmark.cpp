@@ -0,0 +1,336 @@
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#ifdef _WIN32
+#include "mingw.thread.h"
+#else
+#include <thread>
+#endif
+
+#include "Audio/Mixer.h"
+#include "Audio/Tone.h"
+#include "Common/Colour.h"
+#include "Common/Palette.h"
+#include "Common/WaveForm.h"
+#include "Emulator/Basic.h"
+
+namespace {
+    const int32_t Width = 320;
+    const int32_t Height = 240;
+
+    struct Result {
+        std::string name;
+        double nanoseconds;
+    };
+
+    // Returns mean nanoseconds per iteration after a short warm up.
+    double measure(int iterations, const std::function<void()> &body) {
+        for (int i = 0; i < iterations / 10 + 1; i++)
+            body();
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; i++)
+            body();
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        return (double)elapsed / iterations;
+    }
+
+    void print(const std::string &title, const std::vector<Result> &results, const std::string &unit, double units) {
+        std::cout << title << std::endl;
+        std::cout << std::fixed;
+
+        for (const auto &result : results) {
+            std::cout << "  " << std::left << std::setw(24) << result.name << std::right;
+            std::cout << std::setprecision(3) << std::setw(10) << result.nanoseconds / 1000.0 << "us";
+            std::cout << std::setprecision(1) << std::setw(12) << units * 1000000000.0 / result.nanoseconds << " " << unit << "/s";
+            std::cout << std::setprecision(2) << std::setw(8) << results[0].nanoseconds / result.nanoseconds << "x" << std::endl;
+        }
+    }
+
+    int palette() {
+        const int iterations = 2000;
+
+        std::array<uint8_t, Width*Height> screen;
+        std::array<Common::Colour, 256> colours;
+        std::array<uint32_t, Width*Height> rgba;
+        Common::PaletteTable table;
+
+        for (size_t i = 0; i < colours.size(); i++)
+            colours[i] = Common::Colour::Colour8(i);
+
+        for (auto &pixel : screen)
+            pixel = rand() & 0xFF;
+
+        uint32_t checksum = 0;
+        std::vector<Result> results;
+
+        // What onRender used to do: copy the screen and palette out of
+        // SystemIO by value, then pack each pixel's colour on the fly.
+        results.push_back({"transform (copy)", measure(iterations, [&]() {
+            auto copy = screen;
+            auto palette = colours;
+
+            std::transform(copy.begin(), copy.end(), rgba.begin(),
+                [&palette](uint8_t pixel) {
+                    return palette[pixel].RGBA();
+                }
+            );
+
+            checksum += rgba[checksum % rgba.size()];
+        })});
+
+        results.push_back({"scalar", measure(iterations, [&]() {
+            Common::PaletteToRGBA(colours, table);
+            Common::ExpandPaletteScalar(screen.data(), table, rgba.data(), rgba.size());
+
+            checksum += rgba[checksum % rgba.size()];
+        })});
+
+        if (Common::ExpandPaletteAVX2(screen.data(), table, rgba.data(), rgba.size())) {
+            results.push_back({"avx2", measure(iterations, [&]() {
+                Common::PaletteToRGBA(colours, table);
+                Common::ExpandPaletteAVX2(screen.data(), table, rgba.data(), rgba.size());
+
+                checksum += rgba[checksum % rgba.size()];
+            })});
+        }
+
+        print(std::string("Palette expansion, ") + std::to_string(Width) + "x" + std::to_string(Height) + ", dispatching to " + Common::PaletteKernel(), results, "Mpixel", Width * Height / 1000000.0);
+        std::cout << "  (checksum " << std::hex << checksum << std::dec << ")" << std::endl;
+
+        return 0;
+    }
+
+    int dsp() {
+        const int iterations = 200;
+        const int BlockSize = 512;
+        const int Voices = 16;
+
+        // Long enough that no tone runs out during the benchmark
+        const uint16_t Duration = 60000;
+
+        std::array<float, BlockSize> stream;
+        float checksum = 0.0f;
+
+        // Seconds of audio in one block, to turn time per voice into
+        // voices a single core can keep up with.
+        const double blockSeconds = (double)BlockSize / Audio::FREQUENCY;
+
+        std::cout << "Oscillators, " << Voices << " voices of " << BlockSize << " samples, dispatching to " << Audio::OscillatorKernel() << std::endl;
+        std::cout << std::fixed;
+
+        const std::array<std::pair<const char *, uint8_t>, 6> waveForms = {{
+            {"sine", Common::WaveForm::SINE},
+            {"sawtooth", Common::WaveForm::SAWTOOTH},
+            {"triangle", Common::WaveForm::TRIANGLE},
+            {"square", Common::WaveForm::SQUARE},
+            {"noise", Common::WaveForm::NOISE},
+            {"pinknoise", Common::WaveForm::PINKNOISE},
+        }};
+
+        auto report = [&](const std::string &name, double nanoseconds) {
+            double perVoice = nanoseconds / Voices;
+
+            std::cout << "  " << std::left << std::setw(24) << name << std::right;
+            std::cout << std::setprecision(3) << std::setw(10) << perVoice / 1000.0 << "us/voice";
+            std::cout << std::setprecision(0) << std::setw(10) << blockSeconds * 1000000000.0 / perVoice << " voices/core" << std::endl;
+        };
+
+        // What generateSamples used to do per sample: fmod for the
+        // position, sin for the wave and the ADSR branch.
+        {
+            std::array<double, Voices> positions;
+            positions.fill(0.0);
+
+            report("sine (fmod/sin)", measure(iterations, [&]() {
+                stream.fill(0.0f);
+
+                for (int v = 0; v < Voices; v++) {
+                    double freq = 110.0 * (v + 1);
+                    int attackLeft = -1;
+
+                    for (int i = 0; i < BlockSize; i++) {
+                        float attack = 1.0f;
+
+                        if (attackLeft >= 0)
+                            attack -= attackLeft-- * 0.001f;
+
+                        float pos = std::fmod(positions[v]/Audio::FREQUENCY, 1.0);
+                        positions[v] += freq;
+                        stream[i] += attack * 0.25f * std::sin(pos*2*M_PI);
+                    }
+                }
+
+                checksum += stream[0];
+            }));
+        }
+
+        for (const auto &waveForm : waveForms) {
+            std::vector<Audio::Tone> voices(Voices);
+
+            for (int v = 0; v < Voices; v++) {
+                voices[v].seed(v + 1);
+                voices[v].tone(110.0f * (v + 1), Duration, waveForm.second, 255, 10, 10, 200, 10);
+            }
+
+            report(waveForm.first, measure(iterations, [&]() {
+                stream.fill(0.0f);
+
+                for (auto &voice : voices)
+                    voice.generateSamples(stream.data(), stream.size(), 0.25f);
+
+                checksum += stream[0];
+            }));
+        }
+
+        // The whole mixer, stereo with a spread of pans. Its cost should
+        // follow the voices sounding, not the size of the pool.
+        const size_t Pool = 64;
+        std::vector<float> output(BlockSize * 2);
+
+        std::cout << "Mixer, " << Pool << " voice pool, " << BlockSize << " frames, mixing with " << Audio::MixKernel() << std::endl;
+
+        for (size_t sounding : {0, 4, 16, 64}) {
+            Audio::Mixer mixer(0, Pool);
+            mixer.seed(1);
+
+            for (size_t v = 0; v < sounding; v++)
+                mixer.sound(0, 0, 110.0f * (v % 16 + 1), Duration, v % 4, 255, 10, 10, 200, 10, (uint8_t)(v * 255 / Pool));
+
+            mixer.mix(output.data(), BlockSize);
+
+            double nanoseconds = measure(iterations, [&]() {
+                mixer.mix(output.data(), BlockSize);
+                checksum += output[0];
+            });
+
+            std::cout << "  " << std::left << std::setw(24) << (std::to_string(sounding) + " sounding") << std::right;
+            std::cout << std::setprecision(3) << std::setw(10) << nanoseconds / 1000.0 << "us/block";
+
+            if (sounding)
+                std::cout << std::setprecision(0) << std::setw(10) << blockSeconds * 1000000000.0 / (nanoseconds / sounding) << " voices/core";
+
+            std::cout << std::endl;
+        }
+
+        std::cout << "  (checksum " << std::defaultfloat << std::setprecision(9) << checksum << ")" << std::endl;
+
+        return 0;
+    }
+
+    // A generated program of Lines lines, each assigning an expression
+    // nested depth deep, so the cost of one expression shows up as time
+    // per token staying flat or growing with the depth.
+    std::string source(int lines, int depth) {
+        std::string program = "1 LET A = 1\n2 LET B = 2.5\n3 LET X = 0\n";
+        std::string expression = "A";
+
+        for (int i = 0; i < depth; i++)
+            expression = "(" + expression + " + B * " + std::to_string(i + 1) + " - ABS(A))";
+
+        for (int i = 0; i < lines; i++) {
+            uint32_t linenumber = 10 + i;
+
+            if (i % 8 == 7)
+                program += std::to_string(linenumber) + " IF X > A THEN PRINT X\n";
+            else
+                program += std::to_string(linenumber) + " LET X = " + expression + "\n";
+        }
+
+        return program;
+    }
+
+    int compile() {
+        const int Lines = 10000;
+        const int iterations = 5;
+        const std::array<int, 4> depths = {1, 4, 16, 64};
+
+        // parseFile reads from disk, as loading a program does
+        const std::string filename = (std::filesystem::temp_directory_path() / "grape16-bench.bas").string();
+
+        size_t checksum = 0;
+        std::array<std::map<uint32_t, std::vector<Emulator::BasicToken>>, depths.size()> programs;
+        std::array<size_t, depths.size()> tokens;
+
+        auto report = [&](int depth, double nanoseconds, size_t count) {
+            std::cout << "  " << std::left << std::setw(24) << ("depth " + std::to_string(depth)) << std::right;
+            std::cout << std::setprecision(3) << std::setw(10) << nanoseconds / 1000000.0 << "ms";
+            std::cout << std::setprecision(0) << std::setw(12) << Lines * 1000000000.0 / nanoseconds << " lines/s";
+            std::cout << std::setprecision(1) << std::setw(10) << nanoseconds / count << " ns/token" << std::endl;
+        };
+
+        std::cout << "BASIC tokenise, " << Lines << " lines from a file, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+        std::cout << std::fixed;
+
+        for (size_t d = 0; d < depths.size(); d++) {
+            {
+                std::ofstream file(filename, std::ios::binary);
+                file << source(Lines, depths[d]);
+            }
+
+            double nanoseconds = measure(iterations, [&]() {
+                programs[d] = parseFile(filename);
+                checksum += programs[d].size();
+            });
+
+            tokens[d] = 0;
+
+            for (const auto &line : programs[d])
+                tokens[d] += line.second.size();
+
+            report(depths[d], nanoseconds, tokens[d]);
+        }
+
+        std::remove(filename.c_str());
+
+        std::cout << "BASIC compile, " << Lines << " lines" << std::endl;
+
+        for (size_t d = 0; d < depths.size(); d++) {
+            double nanoseconds = measure(iterations, [&]() {
+                Emulator::Program program;
+                Emulator::Compiler compiler;
+
+                compiler.compile(programs[d], program);
+                checksum += program.size();
+            });
+
+            report(depths[d], nanoseconds, tokens[d]);
+        }
+
+        std::cout << "  (checksum " << checksum << ")" << std::endl;
+
+        return 0;
+    }
+};
+
+int Benchmark::Run(const std::string &name) {
+    if (name == "palette")
+        return palette();
+
+    if (name == "dsp")
+        return dsp();
+
+    if (name == "compile")
+        return compile();
+
+    std::cerr << "Unknown benchmark " << name << ", expected one of: palette, dsp, compile" << std::endl;
+    return -1;
+}
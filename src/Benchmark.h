@@ -0,0 +1,12 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <string>
+
+namespace Benchmark {
+    // Runs the named micro benchmark and prints its results, returns
+    // the process exit code.
+    int Run(const std::string &name);
+}; // namespace Benchmark
+
+#endif //__BENCHMARK_H__
@@ -12,6 +12,10 @@ void BaseState::onTick(State *state, const uint32_t time) {
 
 }
 
+bool BaseState::needsRender(State *state) {
+    return true;
+}
+
 void BaseState::onMouseMove(State *state, const MouseMove &event) {
 
 }
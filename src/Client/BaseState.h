@@ -26,6 +26,9 @@ namespace Client {
             virtual void onEnterState(State *state, std::any data);
             virtual void onLeaveState(State *state, std::any data);
 
+            // Whether anything changed that needs drawing this frame
+            virtual bool needsRender(State *state);
+
             virtual void changeDisplayMode(const Common::DisplayMode &displayMode);
 
             virtual ~BaseState();
@@ -0,0 +1,248 @@
+#include "Client/Capture.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+
+using namespace Client;
+
+Capture::Capture(const std::string &videoFilename, const std::string &audioFilename, double rate, bool blocking, size_t voices) : rate(rate), blocking(blocking), y4m(false), running(true), captured(0), droppedFrames(0), droppedSounds(0), canvas(SystemIO::Width, SystemIO::Height), videoFrames(0), pending(false), mixer(0, voices), audioSamples(0), audioEnd(0) {
+    // Fixed noise seeds, as headless runs use, so the same run records
+    // the same samples
+    mixer.seed(1);
+
+    if (!videoFilename.empty()) {
+        video.open(videoFilename, std::ios_base::binary);
+
+        if (!video.is_open()) {
+            std::cerr << "Could not open `" << videoFilename << "'" << std::endl;
+            exit(-1);
+        }
+
+        y4m = videoFilename.size() >= 4 && videoFilename.compare(videoFilename.size() - 4, 4, ".y4m") == 0;
+
+        if (y4m) {
+            video << "YUV4MPEG2 W" << SystemIO::Width << " H" << SystemIO::Height;
+
+            if (rate == std::floor(rate))
+                video << " F" << (uint32_t)rate << ":1";
+            else
+                video << " F" << (uint32_t)(rate * 1000.0) << ":1000";
+
+            video << " Ip A1:1 C444\n";
+        }
+
+        output.resize(SystemIO::Width * SystemIO::Height * 3);
+    }
+
+    if (!audioFilename.empty()) {
+        if (!audio.open(audioFilename)) {
+            std::cerr << "Could not open `" << audioFilename << "'" << std::endl;
+            exit(-1);
+        }
+
+        mix.resize(1024 * 2);
+        samples.resize(mix.size());
+    }
+
+    writer = std::thread(&Capture::write, this);
+}
+
+Capture::~Capture() {
+    stop(0);
+}
+
+void Capture::push(const Event &event, std::atomic<uint64_t> &dropped) {
+    while (!queue.push(event)) {
+        if (!blocking) {
+            dropped++;
+            return;
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+void Capture::frame(const std::shared_ptr<const Frame> &frame) {
+    if (!video.is_open())
+        return;
+
+    Event event;
+    event.frame = frame;
+    event.time = frame->time;
+
+    captured++;
+    push(event, droppedFrames);
+}
+
+void Capture::sound(uint32_t time, const SoundBufferObject &sound) {
+    if (!audio.isOpen())
+        return;
+
+    Event event;
+    event.time = time;
+    event.voice = sound.voice;
+    event.frequency = sound.frequency;
+    event.duration = sound.duration;
+    event.voiceConfig = sound.voiceConfig;
+    event.sequence = sound.sequence;
+    event.delay = sound.delay;
+    event.sample = sound.sample;
+
+    push(event, droppedSounds);
+}
+
+void Capture::write() {
+    Event event;
+
+    while (true) {
+        if (queue.pop(event)) {
+            handle(event);
+            continue;
+        }
+
+        // Only stop once everything queued before stop() is written
+        if (!running)
+            break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Capture::handle(const Event &event) {
+    if (!event.frame) {
+        // Bring the mix up to the note's time, the mixer then starts it
+        // on the first sample of the next block. With no device period
+        // there is no slack, so notes land exactly on their frame.
+        renderAudio((uint64_t)event.time * Audio::FREQUENCY / 1000);
+
+        const auto &config = event.voiceConfig;
+
+        if (event.sequence) {
+            mixer.play(event.time, event.voice, event.sequence, event.delay, config.waveForm, config.volume, config.attack, config.decay, config.sustain, config.release, config.pan);
+            audioEnd = std::max(audioEnd, audioSamples + event.delay + event.sequence->Length());
+        } else if (event.sample) {
+            mixer.pcm(event.time, event.voice, event.sample, event.frequency, config.volume, config.pan);
+
+            if (!event.sample->Looped() && event.frequency > 0.0f)
+                audioEnd = std::max(audioEnd, audioSamples + (uint64_t)((double)event.sample->Length() * Audio::FREQUENCY / event.frequency));
+        } else {
+            mixer.sound(event.time, event.voice, event.frequency, event.duration, config.waveForm, config.volume, config.attack, config.decay, config.sustain, config.release, config.pan);
+            audioEnd = std::max(audioEnd, audioSamples + (uint64_t)event.duration * Audio::FREQUENCY / 1000);
+        }
+
+        return;
+    }
+
+    // Repeat the previous frame until this one is due
+    uint64_t due = (uint64_t)((double)event.frame->time * rate / 1000.0);
+    while (videoFrames < due)
+        writeVideoFrame();
+
+    const Frame &frame = *event.frame;
+
+    Common::PaletteToRGBA(frame.palette, paletteTable);
+    Common::ExpandPalette(frame.screen.data(), paletteTable, rgba.data(), rgba.size());
+
+    canvas.drawBuffer(rgba.data(), SystemIO::Width, SystemIO::Height);
+    DrawText(frame, canvas);
+
+    pending = true;
+}
+
+void Capture::writeVideoFrame() {
+    const uint32_t *pixels = canvas.Pixels();
+    const size_t count = SystemIO::Width * SystemIO::Height;
+
+    if (y4m) {
+        uint8_t *y = output.data();
+        uint8_t *cb = y + count;
+        uint8_t *cr = cb + count;
+
+        // BT.601 studio range
+        for (size_t i = 0; i < count; i++) {
+            int32_t r = (pixels[i] >> 24) & 0xFF;
+            int32_t g = (pixels[i] >> 16) & 0xFF;
+            int32_t b = (pixels[i] >> 8) & 0xFF;
+
+            y[i] = (uint8_t)(((66*r + 129*g + 25*b + 128) >> 8) + 16);
+            cb[i] = (uint8_t)(((-38*r - 74*g + 112*b + 128) >> 8) + 128);
+            cr[i] = (uint8_t)(((112*r - 94*g - 18*b + 128) >> 8) + 128);
+        }
+
+        video.write("FRAME\n", 6);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            output[i*3] = (pixels[i] >> 24) & 0xFF;
+            output[i*3 + 1] = (pixels[i] >> 16) & 0xFF;
+            output[i*3 + 2] = (pixels[i] >> 8) & 0xFF;
+        }
+    }
+
+    video.write((const char *)output.data(), output.size());
+
+    videoFrames++;
+    pending = false;
+}
+
+void Capture::renderAudio(uint64_t until) {
+    if (!audio.isOpen())
+        return;
+
+    while (audioSamples < until) {
+        size_t length = (size_t)std::min<uint64_t>(until - audioSamples, mix.size() / 2);
+
+        // Same mixer as playback
+        mixer.mix(mix.data(), length);
+
+        Audio::ToPCM16(mix.data(), samples.data(), length * 2);
+        audio.write(samples.data(), length);
+        audioSamples += length;
+    }
+}
+
+void Capture::finishAudio(uint32_t time) {
+    // Cover the whole run and video, and any note still sounding after
+    uint64_t end = std::max((uint64_t)time * Audio::FREQUENCY / 1000, (uint64_t)((double)videoFrames * Audio::FREQUENCY / rate));
+    renderAudio(std::max(audioEnd, end));
+
+    audio.close();
+}
+
+void Capture::stop(uint32_t time) {
+    if (!writer.joinable())
+        return;
+
+    running = false;
+    writer.join();
+
+    if (video.is_open()) {
+        if (pending || videoFrames == 0)
+            writeVideoFrame();
+
+        // A screen that stopped changing still lasts to the end of the
+        // run, the same as gaps between frames. The clock is in whole
+        // milliseconds, rounding down, so round to the nearest frame.
+        uint64_t due = (uint64_t)std::llround((double)time * rate / 1000.0);
+        while (videoFrames < due)
+            writeVideoFrame();
+
+        video.close();
+    }
+
+    if (audio.isOpen())
+        finishAudio(time);
+}
+
+std::string Capture::report() const {
+    std::ostringstream s;
+
+    s << "Capture: " << captured.load() << " frames, " << droppedFrames.load() << " dropped, " << videoFrames << " video frames written";
+
+    if (droppedSounds)
+        s << ", " << droppedSounds.load() << " sounds dropped";
+
+    return s.str();
+}
@@ -0,0 +1,103 @@
+#ifndef __CLIENT_CAPTURE_H__
+#define __CLIENT_CAPTURE_H__
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <memory>
+
+#ifdef _WIN32
+#include "mingw.thread.h"
+#else
+#include <thread>
+#endif
+
+#include "Common/SPSCQueue.h"
+#include "Common/Palette.h"
+#include "Client/EmulatorState.h"
+#include "Renderer/Software.h"
+#include "Audio/Mixer.h"
+#include "Audio/WAVFile.h"
+
+namespace Client {
+    // Records published frames and sounds on a background thread. Video is
+    // Y4M (4:4:4) when the filename ends in .y4m and raw RGB24 frames
+    // otherwise, audio is 16 bit stereo WAV from the same mixer used for
+    // playback. Both follow emulated time, so frames that were
+    // never published, up to the end of the run, are filled in by
+    // repeating the previous one.
+    class Capture {
+            struct Event {
+                // Null for sounds
+                std::shared_ptr<const Frame> frame;
+                uint32_t time;
+
+                uint8_t voice;
+                float frequency;
+                uint16_t duration;
+                VoiceConfig voiceConfig;
+                std::shared_ptr<const Audio::Sequence> sequence;
+                uint32_t delay;
+                std::shared_ptr<const Audio::Sample> sample;
+            };
+
+            const double rate;
+            const bool blocking;
+
+            std::ofstream video;
+            bool y4m;
+            Audio::WAVFile audio;
+
+            Common::SPSCQueue<Event, 256> queue;
+            std::thread writer;
+            std::atomic<bool> running;
+
+            std::atomic<uint64_t> captured;
+            std::atomic<uint64_t> droppedFrames;
+            std::atomic<uint64_t> droppedSounds;
+
+            // Owned by the writer thread
+            Renderer::Software canvas;
+            Common::PaletteTable paletteTable;
+            std::array<uint32_t, SystemIO::Width*SystemIO::Height> rgba;
+            std::vector<uint8_t> output;
+            uint64_t videoFrames;
+            bool pending;
+
+            Audio::Mixer mixer;
+            std::vector<float> mix;
+            std::vector<int16_t> samples;
+            uint64_t audioSamples;
+            uint64_t audioEnd;
+
+            void push(const Event &event, std::atomic<uint64_t> &dropped);
+            void write();
+            void handle(const Event &event);
+            void writeVideoFrame();
+            void renderAudio(uint64_t until);
+            void finishAudio(uint32_t time);
+        public:
+            // Either filename may be empty. A blocking capture waits for
+            // room in the queue instead of dropping, for runs that have to
+            // be complete rather than real time.
+            Capture(const std::string &videoFilename, const std::string &audioFilename, double rate=60.0, bool blocking=false, size_t voices=Audio::DEFAULT_VOICES);
+            ~Capture();
+
+            // Called from the emulation thread, see EmulatorState listeners
+            void frame(const std::shared_ptr<const Frame> &frame);
+            void sound(uint32_t time, const SoundBufferObject &sound);
+
+            // Writes everything still queued, holds the last frame and
+            // any sound up to time, the emulated end of the run in
+            // milliseconds, and closes the files
+            void stop(uint32_t time);
+
+            // Only complete after stop()
+            std::string report() const;
+    };
+};
+
+#endif //__CLIENT_CAPTURE_H__
@@ -0,0 +1,66 @@
+#ifndef __CLIENT_CONSOLE_H__
+#define __CLIENT_CONSOLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+namespace Client {
+    struct Cell {
+        char character;
+        uint8_t foreground;
+        uint8_t background;
+    };
+
+    // Fixed size character grid kept as a ring of rows, so scrolling
+    // just moves the index of the top row instead of any text.
+    template <size_t Columns, size_t Rows> class Console {
+        private:
+            std::array<Cell, Columns*Rows> cells;
+            size_t top;
+
+            Cell *physical(size_t row) {
+                return cells.data() + ((top + row) % Rows) * Columns;
+            }
+
+            const Cell *physical(size_t row) const {
+                return cells.data() + ((top + row) % Rows) * Columns;
+            }
+
+            void fill(size_t row, const Cell &blank) {
+                Cell *cell = physical(row);
+                for (size_t column = 0; column < Columns; column++)
+                    cell[column] = blank;
+            }
+        public:
+            Console() : top(0) {
+                clear(0, 0);
+            }
+
+            void clear(uint8_t foreground, uint8_t background) {
+                top = 0;
+                cells.fill({' ', foreground, background});
+            }
+
+            // Drops the top row and brings in a blank one at the bottom
+            void scroll(uint8_t foreground, uint8_t background) {
+                fill(0, {' ', foreground, background});
+                top = (top + 1) % Rows;
+            }
+
+            Cell &at(size_t row, size_t column) {
+                return physical(row)[column];
+            }
+
+            const Cell &at(size_t row, size_t column) const {
+                return physical(row)[column];
+            }
+
+            // Read-only view of the Columns cells making up a row
+            const Cell *row(size_t row) const {
+                return physical(row);
+            }
+    };
+}; // namespace Client
+
+#endif //__CLIENT_CONSOLE_H__
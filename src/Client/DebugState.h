@@ -73,7 +73,21 @@ namespace Client {
             void sound(uint8_t voice, float frequency, uint16_t duration) {
             }
 
-            void voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
+            void voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+            }
+
+            bool play(uint8_t voice, const std::string &tune) {
+                return true;
+            }
+
+            uint16_t playing(uint8_t voice) {
+                return 0;
+            }
+
+            void sample(uint8_t id, std::vector<int16_t> pcm, uint32_t loopStart, uint32_t loopEnd) {
+            }
+
+            void pcm(uint8_t voice, uint8_t id, float rate) {
             }
     };
 
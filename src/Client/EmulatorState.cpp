@@ -2,13 +2,17 @@
 #include "Client/EmulatorState.h"
 #include "Common/Keys.h"
 #include "Common/WaveForm.h"
+#include "Common/Palette.h"
 
 #include <vector>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 
 using namespace Client;
 
-SystemIO::SystemIO() : cursor(0,0),currentPalette(1), background(0), foreground(255), fontSize(8) {
+SystemIO::SystemIO() : cursor(0,0),currentPalette(1), background(0), foreground(255), fontSize(8), sequence(0) {
     palettes.resize(4);
 
     for (size_t i = 0; i < palettes[0].size(); i++) {
@@ -323,25 +327,26 @@ SystemIO::SystemIO() : cursor(0,0),currentPalette(1), background(0), foreground(
 
     cls();
 
-    screenbuffer[cursor.Y()][cursor.X()] = (char)255;
+    console.at(cursor.Y(), cursor.X()).character = (char)255;
 
     nextKeyId = 1;
 }
 
 void SystemIO::cls() {
+    dirtyPixels.markAll(Width);
+    dirtyText.markAll(chars);
+
     screen.fill(background);
     cursor = Point(0,0);
-    screenbuffer.clear();
-    screenbuffer.resize(lines);
-    for (size_t i=0; i < screenbuffer.size(); i++) {
-        screenbuffer[i].fill(' ');
-        screenbuffer[i][screenbuffer.size()] = 0;
-    }
+    console.clear(foreground, background);
+    clearBackground = background;
 }
 
 void SystemIO::setpixel(uint16_t x, uint16_t y, uint8_t pixel) {
-    if (x < Width && y < Height)
+    if (x < Width && y < Height) {
         screen[y*Width + x] = pixel;
+        dirtyPixels.mark(y, x, x + 1);
+    }
 }
 
 uint8_t SystemIO::getpixel(uint16_t x, uint16_t y) {
@@ -359,7 +364,8 @@ void SystemIO::write(uint8_t c) {
     } else if (chr == 8) {
         if (cursor != Point(0,0)) {
             cursor = (cursor - Point(1,0));
-            screenbuffer[cursor.Y()][cursor.X()] = ' ';
+            console.at(cursor.Y(), cursor.X()) = {' ', foreground, background};
+            markText(cursor.Y(), cursor.X());
         }
         return;
     } else if (chr == '\t') {
@@ -373,15 +379,17 @@ void SystemIO::write(uint8_t c) {
 
     if (cursor.Y() >= lines) {
         cursor = cursor - Point(0, 1);
-        screenbuffer.erase(screenbuffer.begin());
-        screenbuffer.push_back(std::array<char, chars+1>());
+        console.scroll(foreground, background);
+        dirtyText.markAll(chars);
     }
 
+    markText(cursor.Y(), cursor.X());
+
     if (chr) {
-        screenbuffer[cursor.Y()][cursor.X()] = chr;
+        console.at(cursor.Y(), cursor.X()) = {chr, foreground, background};
         cursor = (cursor + Point(1,0));
     } else {
-        screenbuffer[cursor.Y()][cursor.X()] = (char)255;
+        console.at(cursor.Y(), cursor.X()) = {(char)255, foreground, background};
     }
 }
 
@@ -429,16 +437,132 @@ void SystemIO::blit(uint16_t x, uint16_t y, std::vector<uint8_t> buffer) {
     ptr += y*Width + x;
 
     std::memcpy(ptr, buffer.data(), buffer.size());
+
+    if (buffer.size() == 0)
+        return;
+
+    // The copy runs on past the end of the row into the following ones
+    size_t start = y*Width + x;
+    size_t end = start + buffer.size();
+    size_t top = start / Width;
+    size_t bottom = (end - 1) / Width;
+
+    if (top == bottom) {
+        dirtyPixels.mark(top, start % Width, (end - 1) % Width + 1);
+    } else {
+        for (size_t row = top; row <= bottom; row++)
+            dirtyPixels.mark(row, 0, Width);
+    }
+}
+
+void SystemIO::snapshot(Frame &frame) {
+    frame.sequence = ++sequence;
+    frame.dirtyPixels = dirtyPixels;
+    frame.dirtyText = dirtyText;
+
+    dirtyPixels.clear();
+    dirtyText.clear();
+
+    frame.time = time;
+
+    frame.screen = screen;
+    frame.palette = palettes[currentPalette];
+    frame.text = console;
+    frame.clearBackground = clearBackground;
+    frame.fontSize = fontSize;
+    frame.cursor = cursor;
 }
 
 void SystemIO::sound(uint8_t voice, float frequency, uint16_t duration) {
+    if (voice >= voices.size())
+        return;
+
     auto voiceConfig = voices[voice];
 
+    // Silencing a voice stops its tunes too
+    if (duration == 0)
+        tunes[voice].clear();
+
     soundBuffer.push(SoundBufferObject(voice, frequency, duration, voiceConfig));
 }
 
-void SystemIO::voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
-    voices[voice] = VoiceConfig(waveForm, volume, attack, decay, sustain, release);
+void SystemIO::expireTunes(uint8_t voice, uint64_t now) {
+    auto &queued = tunes[voice];
+
+    while (!queued.empty() && queued.front().start + queued.front().sequence->Length() <= now)
+        queued.pop_front();
+}
+
+bool SystemIO::play(uint8_t voice, const std::string &tune) {
+    if (voice >= voices.size())
+        return true;
+
+    uint64_t now = (uint64_t)time * Audio::FREQUENCY / 1000;
+    auto &queued = tunes[voice];
+
+    expireTunes(voice, now);
+
+    // Wait for room, as the mixers only hold so many tunes per voice
+    if (queued.size() >= Audio::MAX_TUNES)
+        return false;
+
+    auto sequence = std::make_shared<const Audio::Sequence>(tune);
+    uint64_t start = now;
+
+    if (!queued.empty())
+        start = std::max(start, queued.back().start + queued.back().sequence->Length());
+
+    queued.push_back({start, sequence});
+    soundBuffer.push(SoundBufferObject(voice, sequence, (uint32_t)(start - now), voices[voice]));
+
+    return true;
+}
+
+void SystemIO::sample(uint8_t id, std::vector<int16_t> pcm, uint32_t loopStart, uint32_t loopEnd) {
+    // Notes already playing keep the sample they started with
+    samples[id] = std::make_shared<const Audio::Sample>(std::move(pcm), loopStart, loopEnd);
+}
+
+void SystemIO::pcm(uint8_t voice, uint8_t id, float rate) {
+    if (voice >= voices.size() || !samples[id])
+        return;
+
+    soundBuffer.push(SoundBufferObject(voice, samples[id], rate, voices[voice]));
+}
+
+uint16_t SystemIO::playing(uint8_t voice) {
+    if (voice >= voices.size())
+        return 0;
+
+    uint64_t now = (uint64_t)time * Audio::FREQUENCY / 1000;
+    size_t count = 0;
+
+    expireTunes(voice, now);
+
+    for (const auto &tune : tunes[voice]) {
+        const auto &notes = tune.sequence->Notes();
+
+        if (now < tune.start) {
+            count += notes.size();
+            continue;
+        }
+
+        // Notes at or before now have started
+        auto started = std::upper_bound(notes.begin(), notes.end(), now - tune.start, [](uint64_t position, const Audio::Sequence::Note &note) {
+            return position < note.start;
+        });
+
+        count += notes.end() - started;
+    }
+
+    return (uint16_t)std::min<size_t>(count, INT16_MAX);
+}
+
+void SystemIO::voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    if (voice >= voices.size())
+        return;
+
+    voices[voice] = VoiceConfig(waveForm, volume, attack, decay, sustain, release, pan);
 }
 
 /*
@@ -515,23 +639,100 @@ void SystemIO::mouseup(const MouseClick &click) {
 }
 
 
+bool EmulatorState::needsRender(State *state) {
+    auto latest = frames.latest();
+
+    if (latest && (!shown || latest->sequence != shown->sequence)) {
+        shown = latest;
+        fresh = true;
+    }
+
+    return fresh || redraw || fastForward;
+}
+
 void EmulatorState::onRender(State *state, const uint32_t time) {
-    static std::array<uint32_t, SystemIO::Width * SystemIO::Height> buffer;
-    auto screen = sysio->getScreen();
-    auto palette = sysio->getCurrentPalette();
+    // Not every main loop asks first
+    needsRender(state);
+
+    const Frame &frame = *shown;
+
+    bands.clear();
+
+    if (fresh || redraw) {
+        Common::PaletteToRGBA(frame.palette, paletteTable);
+
+        // Frames the render thread never saw may have changed anything
+        if (redraw || frame.sequence != presented + 1) {
+            Common::ExpandPalette(frame.screen.data(), paletteTable, rgba.data(), rgba.size());
+            bands.push_back({0, SystemIO::Height});
+        } else {
+            for (int32_t y = 0; y < SystemIO::Height; y++) {
+                if (!frame.dirtyPixels.isDirty(y))
+                    continue;
 
-    std::transform(screen.begin(), screen.end(), buffer.begin(),
-        [palette](uint8_t pixel) {
-            return palette[pixel].RGBA();
+                size_t offset = y * SystemIO::Width + frame.dirtyPixels.First(y);
+                Common::ExpandPalette(frame.screen.data() + offset, paletteTable, rgba.data() + offset, frame.dirtyPixels.Last(y) - frame.dirtyPixels.First(y));
+            }
+
+            frame.dirtyPixels.forEachBand([this](size_t top, size_t count) {
+                bands.push_back({(uint32_t)top, (uint32_t)count});
+            });
         }
-    );
 
-    state->getRenderer()->drawBuffer(buffer.data(), SystemIO::Width, SystemIO::Height);
+        presented = frame.sequence;
+        fresh = false;
+        redraw = false;
+    }
+
+    auto renderer = state->getRenderer();
+
+    renderer->drawBufferRows(rgba.data(), SystemIO::Width, SystemIO::Height, bands);
+    DrawText(frame, *renderer);
+
+    if (fastForward) {
+        const int32_t size = frame.fontSize;
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(1) << ">>" << Speed() << "x";
+
+        std::string status = s.str();
+        renderer->drawString(SystemIO::Width - status.size()*size, 0, size, size, status, Common::Colour::White);
+    }
+}
+
+void Client::DrawText(const Frame &frame, Renderer::Base &renderer) {
+    // Reused between frames to keep allocation off the render path
+    static thread_local std::string run;
+    const int32_t size = frame.fontSize;
 
-    uint16_t lineoffset = 0;
-    for (auto line : sysio->getScreenBuffer()) {
-        state->getRenderer()->drawString(0, lineoffset*sysio->FontSize(), sysio->FontSize(), sysio->FontSize(), std::string(line.data()), sysio->getForeground().RGBA());
-        lineoffset++;
+    // Backgrounds go down first so the text is drawn over them
+    for (int32_t y = 0; y < SystemIO::lines; y++) {
+        const Cell *row = frame.text.row(y);
+
+        for (int32_t x = 0; x < SystemIO::chars;) {
+            uint8_t background = row[x].background;
+            int32_t start = x;
+
+            while (x < SystemIO::chars && row[x].background == background)
+                x++;
+
+            if (background != frame.clearBackground)
+                renderer.drawRect(start*size, y*size, (x - start)*size, size, frame.palette[background]);
+        }
+    }
+
+    for (int32_t y = 0; y < SystemIO::lines; y++) {
+        const Cell *row = frame.text.row(y);
+
+        for (int32_t x = 0; x < SystemIO::chars;) {
+            uint8_t foreground = row[x].foreground;
+            int32_t start = x;
+
+            run.clear();
+            while (x < SystemIO::chars && row[x].foreground == foreground)
+                run += row[x++].character;
+
+            renderer.drawString(start*size, y*size, size, size, run, frame.palette[foreground]);
+        }
     }
 }
 
@@ -545,26 +746,253 @@ static std::string str_toupper(std::string s) {
 }
 
 void EmulatorState::onTick(State *state, const uint32_t time) {
-    static bool done = false;
+    if (!sys)
+        sys = state->getSys();
+
+    if (!threaded) {
+        if (!fastForward) {
+            // Ticks follow the display, so step once per pacer period
+            // of tick time to keep emulated speed independent of the
+            // refresh rate. A step is due from half a period on, so
+            // ticks close to the period still step exactly once.
+            backlog = std::min(backlog + (int64_t)time * 1000000, MaxBacklog);
+
+            while (backlog >= pacer.Period() / 2) {
+                backlog -= pacer.Period();
+
+                step(pacer.elapsedMilliseconds(pacer.Period()), backlog < pacer.Period() / 2);
+                measure(pacer.Period());
+            }
+
+            return;
+        }
+
+        // Leave a quarter of the frame for rendering and event handling
+        // so input stays responsive while fast-forwarding.
+        int64_t until = Common::FramePacer::Now() + pacer.Period() * 3 / 4;
+        bool done = false;
+
+        while (!done) {
+            done = frameskip ? skipped + 1 >= frameskip : Common::FramePacer::Now() >= until;
+            skipped = done ? 0 : skipped + 1;
+
+            step(pacer.elapsedMilliseconds(pacer.Period()), done);
+            measure(pacer.Period());
+        }
+
+        return;
+    }
+
+    if (!running) {
+        running = true;
+        worker = std::thread(&EmulatorState::emulate, this);
+    }
+}
+
+void EmulatorState::measure(int64_t slice) {
+    // Slices run under a lowered budget only count for part of one
+    emulated += slice * budget / clockspeed;
+
+    int64_t now = Common::FramePacer::Now();
+    int64_t elapsed = now - speedStart;
+
+    if (elapsed < SpeedWindow)
+        return;
+
+    speed = (double)emulated / (double)elapsed;
+    if (speed > peak)
+        peak = speed.load();
+
+    emulated = 0;
+    speedStart = now;
+}
+
+void EmulatorState::govern(int64_t elapsed, uint64_t cycles) {
+    if (cycles == 0)
+        return;
+
+    // Track host nanoseconds per cycle rather than per slice so the
+    // estimate does not depend on the budget it is used to pick.
+    double cost = (double)elapsed / (double)cycles;
+    costPerCycle = costPerCycle > 0.0 ? costPerCycle + (cost - costPerCycle) / 8.0 : cost;
+
+    double ideal = (double)pacer.Period() * GovernorTarget / costPerCycle;
+    uint32_t next = (uint32_t)std::clamp(ideal, (double)minBudget, (double)maxBudget);
+
+    // A program that yields before using its budget gives no evidence
+    // that a bigger one would fit, so only ever lower it then.
+    if (next > budget && cycles < budget)
+        return;
+
+    budget = next;
+}
+
+bool EmulatorState::present() {
+    if (frameskip) {
+        if (++skipped < frameskip)
+            return false;
+
+        skipped = 0;
+        return true;
+    }
+
+    int64_t now = Common::FramePacer::Now();
+    if (now < nextPresent)
+        return false;
+
+    nextPresent = now + pacer.Period();
+    return true;
+}
+
+void EmulatorState::emulate() {
+    bool fastForwarding = false;
+
+    pacer.reset();
+
+    while (running) {
+        if (paused) {
+            idle = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            pacer.resync();
+            continue;
+        }
+
+        idle = false;
+
+        if (fastForward) {
+            // Emulated time still advances a nominal frame per slice so
+            // programs see a consistent clock, just more of it.
+            fastForwarding = true;
+            step(pacer.elapsedMilliseconds(pacer.Period()), present());
+            measure(pacer.Period());
+            continue;
+        }
+
+        if (fastForwarding) {
+            fastForwarding = false;
+            pacer.resync();
+        }
+
+        int64_t elapsed = pacer.wait();
+        step(pacer.elapsedMilliseconds(elapsed));
+        measure(elapsed);
+    }
+
+    idle = true;
+}
+
+std::string EmulatorState::report() const {
+    std::ostringstream s;
+
+    s << std::fixed << std::setprecision(2);
+    s << "Speed: " << Speed() << "x of " << MHz() << "MHz, peak " << peak.load() << "x";
+
+    if (governed)
+        s << ", governor " << EffectiveMHz() << "MHz (" << minBudget * 60.0 / 1000000.0 << "-" << maxBudget * 60.0 / 1000000.0 << "MHz)";
+
+    return s.str();
+}
+
+void EmulatorState::stop() {
+    running = false;
+
+    if (worker.joinable())
+        worker.join();
+}
+
+void EmulatorState::onEnterState(State *state, std::any data) {
+    paused = false;
+    redraw = true;
+}
+
+void EmulatorState::onLeaveState(State *state, std::any data) {
+    if (!running)
+        return;
+
+    // Other states drive the VM directly, wait until the emulation
+    // thread has let go of it.
+    paused = true;
+    while (!idle)
+        std::this_thread::yield();
+}
+
+void EmulatorState::processInput() {
+    InputEvent event;
+
+    while (input.pop(event)) {
+        switch (event.type) {
+            case InputEvent::Type::KeyDown:
+                sysio->keydown(event.key);
+                break;
+            case InputEvent::Type::KeyUp:
+                sysio->keyup(event.key);
+                break;
+            case InputEvent::Type::MouseMove:
+                sysio->mousemove(event.position);
+                break;
+            case InputEvent::Type::MouseDown:
+                sysio->mousedown(event.click);
+                break;
+            case InputEvent::Type::MouseUp:
+                sysio->mouseup(event.click);
+                break;
+        }
+    }
+}
+
+void EmulatorState::step(const uint32_t time, bool present) {
+    processInput();
+    tick(time);
+
+    if (!present || !sysio->changed())
+        return;
+
+    sysio->snapshot(frames.write());
+    auto published = frames.publish();
+
+    for (const auto &listener : listeners)
+        listener(published);
+}
+
+void EmulatorState::tick(const uint32_t time) {
     static std::string input = "";
     static std::shared_ptr<Emulator::Debugger> debugger = std::make_shared<Emulator::Debugger>();
 
     sysio->setTime(time);
 
-    if (!done) {
+    if (!halted) {
+        int64_t start = Common::FramePacer::Now();
+        uint64_t cycles = vm->Cycles();
+
         try {
-            done = vm->run(std::dynamic_pointer_cast<Emulator::SysIO>(sysio), *program, clockspeed, debug ? debugger : NULL);
+            halted = vm->run(std::dynamic_pointer_cast<Emulator::SysIO>(sysio), *program, budget, debug ? debugger : NULL);
         } catch (const std::runtime_error &re) {
             sysio->puts(std::string("Runtime Error: ") + re.what() + std::string("\n"));
-            done = true;
+            halted = true;
             return;
         }
 
+        if (governed)
+            govern(Common::FramePacer::Now() - start, vm->Cycles() - cycles);
+
+        // Sound is dropped while fast-forwarding, it would only back
+        // up the audio queue for minutes.
         std::optional<SoundBufferObject> s = sysio->nextSound();
         while (s != std::nullopt) {
             auto sound = *s;
-            auto voice = sysio->getVoice(sound.voice);
-            state->getSys()->sound(sound.voice, sound.frequency, sound.duration, voice.waveForm, voice.volume, voice.attack, voice.decay, voice.sustain, voice.release);
+            const auto &voice = sysio->getVoice(sound.voice);
+
+            for (const auto &listener : soundListeners)
+                listener(sysio->clock(), sound);
+
+            if (!fastForward) {
+                if (sound.sequence)
+                    sys->play(sysio->clock(), sound.voice, sound.sequence, sound.delay, voice.waveForm, voice.volume, voice.attack, voice.decay, voice.sustain, voice.release, voice.pan);
+                else if (sound.sample)
+                    sys->pcm(sysio->clock(), sound.voice, sound.sample, sound.frequency, voice.volume, voice.pan);
+                else
+                    sys->sound(sysio->clock(), sound.voice, sound.frequency, sound.duration, voice.waveForm, voice.volume, voice.attack, voice.decay, voice.sustain, voice.release, voice.pan);
+            }
             s = sysio->nextSound();
         }
 
@@ -589,7 +1017,7 @@ void EmulatorState::onTick(State *state, const uint32_t time) {
                 try {
                     compile(basic, *program);
                     vm->Jump(run);
-                    done = false;
+                    halted = false;
                 } catch (const std::invalid_argument &ia) {
                     sysio->puts(ia.what() + std::string("\n"));
                 } catch (const std::domain_error &de) {
@@ -610,7 +1038,7 @@ void EmulatorState::onTick(State *state, const uint32_t time) {
                     try {
                         compile(cmd, *program);
                         vm->Jump(run);
-                        done = false;
+                        halted = false;
                     } catch (const std::invalid_argument &ia) {
                         sysio->puts(ia.what() + std::string("\n"));
                     } catch (const std::domain_error &de) {
@@ -633,230 +1061,255 @@ void EmulatorState::onMouseMove(State *state, const MouseMove &event) {
     Point move;
     Point real(event.x, event.y);
     if (state->getRenderer()->translatePoint(move, real)) {
-        sysio->mousemove(move);
+        InputEvent input;
+        input.type = InputEvent::Type::MouseMove;
+        input.position = move;
+        this->input.push(input);
     }
 }
 
 void EmulatorState::onMouseButtonPress(State *state, const MouseClick &event) {
-    sysio->mousedown(event);
+    InputEvent input;
+    input.type = InputEvent::Type::MouseDown;
+    input.click = event;
+    this->input.push(input);
 }
 
 void EmulatorState::onMouseButtonRelease(State *state, const MouseClick &event) {
-    sysio->mouseup(event);
+    InputEvent input;
+    input.type = InputEvent::Type::MouseUp;
+    input.click = event;
+    this->input.push(input);
+}
+
+void EmulatorState::keydown(char key) {
+    InputEvent event;
+    event.type = InputEvent::Type::KeyDown;
+    event.key = key;
+    input.push(event);
+}
+
+void EmulatorState::keyup(char key) {
+    InputEvent event;
+    event.type = InputEvent::Type::KeyUp;
+    event.key = key;
+    input.push(event);
 }
 
 void EmulatorState::onKeyDown(State *state, const KeyPress &event) {
     if (event.keyCode == Common::Keys::A) {
-        sysio->keydown(event.shiftMod ? 'A' : 'a');
+        keydown(event.shiftMod ? 'A' : 'a');
     } else if (event.keyCode == Common::Keys::B) {
-        sysio->keydown(event.shiftMod ? 'B' : 'b');
+        keydown(event.shiftMod ? 'B' : 'b');
     } else if (event.keyCode == Common::Keys::C) {
-        sysio->keydown(event.shiftMod ? 'C' : 'c');
+        keydown(event.shiftMod ? 'C' : 'c');
     } else if (event.keyCode == Common::Keys::D) {
-        sysio->keydown(event.shiftMod ? 'D' : 'd');
+        keydown(event.shiftMod ? 'D' : 'd');
     } else if (event.keyCode == Common::Keys::E) {
-        sysio->keydown(event.shiftMod ? 'E' : 'e');
+        keydown(event.shiftMod ? 'E' : 'e');
     } else if (event.keyCode == Common::Keys::F) {
-        sysio->keydown(event.shiftMod ? 'F' : 'f');
+        keydown(event.shiftMod ? 'F' : 'f');
     } else if (event.keyCode == Common::Keys::G) {
-        sysio->keydown(event.shiftMod ? 'G' : 'g');
+        keydown(event.shiftMod ? 'G' : 'g');
     } else if (event.keyCode == Common::Keys::H) {
-        sysio->keydown(event.shiftMod ? 'H' : 'h');
+        keydown(event.shiftMod ? 'H' : 'h');
     } else if (event.keyCode == Common::Keys::I) {
-        sysio->keydown(event.shiftMod ? 'I' : 'i');
+        keydown(event.shiftMod ? 'I' : 'i');
     } else if (event.keyCode == Common::Keys::J) {
-        sysio->keydown(event.shiftMod ? 'J' : 'j');
+        keydown(event.shiftMod ? 'J' : 'j');
     } else if (event.keyCode == Common::Keys::K) {
-        sysio->keydown(event.shiftMod ? 'K' : 'k');
+        keydown(event.shiftMod ? 'K' : 'k');
     } else if (event.keyCode == Common::Keys::L) {
-        sysio->keydown(event.shiftMod ? 'L' : 'l');
+        keydown(event.shiftMod ? 'L' : 'l');
     } else if (event.keyCode == Common::Keys::M) {
-        sysio->keydown(event.shiftMod ? 'M' : 'm');
+        keydown(event.shiftMod ? 'M' : 'm');
     } else if (event.keyCode == Common::Keys::N) {
-        sysio->keydown(event.shiftMod ? 'N' : 'n');
+        keydown(event.shiftMod ? 'N' : 'n');
     } else if (event.keyCode == Common::Keys::O) {
-        sysio->keydown(event.shiftMod ? 'O' : 'o');
+        keydown(event.shiftMod ? 'O' : 'o');
     } else if (event.keyCode == Common::Keys::P) {
-        sysio->keydown(event.shiftMod ? 'P' : 'p');
+        keydown(event.shiftMod ? 'P' : 'p');
     } else if (event.keyCode == Common::Keys::Q) {
-        sysio->keydown(event.shiftMod ? 'Q' : 'q');
+        keydown(event.shiftMod ? 'Q' : 'q');
     } else if (event.keyCode == Common::Keys::R) {
-        sysio->keydown(event.shiftMod ? 'R' : 'r');
+        keydown(event.shiftMod ? 'R' : 'r');
     } else if (event.keyCode == Common::Keys::S) {
-        sysio->keydown(event.shiftMod ? 'S' : 's');
+        keydown(event.shiftMod ? 'S' : 's');
     } else if (event.keyCode == Common::Keys::T) {
-        sysio->keydown(event.shiftMod ? 'T' : 't');
+        keydown(event.shiftMod ? 'T' : 't');
     } else if (event.keyCode == Common::Keys::U) {
-        sysio->keydown(event.shiftMod ? 'U' : 'u');
+        keydown(event.shiftMod ? 'U' : 'u');
     } else if (event.keyCode == Common::Keys::V) {
-        sysio->keydown(event.shiftMod ? 'V' : 'v');
+        keydown(event.shiftMod ? 'V' : 'v');
     } else if (event.keyCode == Common::Keys::W) {
-        sysio->keydown(event.shiftMod ? 'W' : 'w');
+        keydown(event.shiftMod ? 'W' : 'w');
     } else if (event.keyCode == Common::Keys::X) {
-        sysio->keydown(event.shiftMod ? 'X' : 'x');
+        keydown(event.shiftMod ? 'X' : 'x');
     } else if (event.keyCode == Common::Keys::Y) {
-        sysio->keydown(event.shiftMod ? 'Y' : 'y');
+        keydown(event.shiftMod ? 'Y' : 'y');
     } else if (event.keyCode == Common::Keys::Z) {
-        sysio->keydown(event.shiftMod ? 'Z' : 'z');
+        keydown(event.shiftMod ? 'Z' : 'z');
     } else if (event.keyCode == Common::Keys::Num1) {
-        sysio->keydown(event.shiftMod ? '!' : '1');
+        keydown(event.shiftMod ? '!' : '1');
     } else if (event.keyCode == Common::Keys::Num2) {
-        sysio->keydown(event.shiftMod ? '@' : '2');
+        keydown(event.shiftMod ? '@' : '2');
     } else if (event.keyCode == Common::Keys::Num3) {
-        sysio->keydown(event.shiftMod ? '#' : '3');
+        keydown(event.shiftMod ? '#' : '3');
     } else if (event.keyCode == Common::Keys::Num4) {
-        sysio->keydown(event.shiftMod ? '$' : '4');
+        keydown(event.shiftMod ? '$' : '4');
     } else if (event.keyCode == Common::Keys::Num5) {
-        sysio->keydown(event.shiftMod ? '%' : '5');
+        keydown(event.shiftMod ? '%' : '5');
     } else if (event.keyCode == Common::Keys::Num6) {
-        sysio->keydown(event.shiftMod ? '^' : '6');
+        keydown(event.shiftMod ? '^' : '6');
     } else if (event.keyCode == Common::Keys::Num7) {
-        sysio->keydown(event.shiftMod ? '&' : '7');
+        keydown(event.shiftMod ? '&' : '7');
     } else if (event.keyCode == Common::Keys::Num8) {
-        sysio->keydown(event.shiftMod ? '*' : '8');
+        keydown(event.shiftMod ? '*' : '8');
     } else if (event.keyCode == Common::Keys::Num9) {
-        sysio->keydown(event.shiftMod ? '(' : '9');
+        keydown(event.shiftMod ? '(' : '9');
     } else if (event.keyCode == Common::Keys::Num0) {
-        sysio->keydown(event.shiftMod ? ')' : '0');
+        keydown(event.shiftMod ? ')' : '0');
     } else if (event.keyCode == Common::Keys::Backquote) {
-        sysio->keydown(event.shiftMod ? '~' : '`');
+        keydown(event.shiftMod ? '~' : '`');
     } else if (event.keyCode == Common::Keys::LBracket) {
-        sysio->keydown(event.shiftMod ? '{' : '[');
+        keydown(event.shiftMod ? '{' : '[');
     } else if (event.keyCode == Common::Keys::RBracket) {
-        sysio->keydown(event.shiftMod ? '}' : ']');
+        keydown(event.shiftMod ? '}' : ']');
     } else if (event.keyCode == Common::Keys::Semicolon) {
-        sysio->keydown(event.shiftMod ? ':' : ';');
+        keydown(event.shiftMod ? ':' : ';');
     } else if (event.keyCode == Common::Keys::Comma) {
-        sysio->keydown(event.shiftMod ? '<' : ',');
+        keydown(event.shiftMod ? '<' : ',');
     } else if (event.keyCode == Common::Keys::Period) {
-        sysio->keydown(event.shiftMod ? '>' : '.');
+        keydown(event.shiftMod ? '>' : '.');
     } else if (event.keyCode == Common::Keys::Quote) {
-        sysio->keydown(event.shiftMod ? '"' : '\'');
+        keydown(event.shiftMod ? '"' : '\'');
     } else if (event.keyCode == Common::Keys::Slash) {
-        sysio->keydown(event.shiftMod ? '?' : '/');
+        keydown(event.shiftMod ? '?' : '/');
     } else if (event.keyCode == Common::Keys::Backslash) {
-        sysio->keydown(event.shiftMod ? '|' : '\\');
+        keydown(event.shiftMod ? '|' : '\\');
     } else if (event.keyCode == Common::Keys::Equal) {
-        sysio->keydown(event.shiftMod ? '+' : '=');
+        keydown(event.shiftMod ? '+' : '=');
     } else if (event.keyCode == Common::Keys::Hyphen) {
-        sysio->keydown(event.shiftMod ? '_' : '-');
+        keydown(event.shiftMod ? '_' : '-');
     } else if (event.keyCode == Common::Keys::Enter) {
-        sysio->keydown('\n');
+        keydown('\n');
     } else if (event.keyCode == Common::Keys::Tab) {
-        sysio->keydown('\t');
+        keydown('\t');
     } else if (event.keyCode == Common::Keys::Space) {
-        sysio->keydown(' ');
+        keydown(' ');
     } else if (event.keyCode == Common::Keys::Backspace) {
-        sysio->keydown(8);
+        keydown(8);
     } else if (event.keyCode == Common::Keys::F1) {
         state->changeState(1);
     } else if (event.keyCode == Common::Keys::F2) {
         state->changeState(2, std::make_any<std::shared_ptr<Emulator::Program>>(program));
+    } else if (event.keyCode == Common::Keys::F3) {
+        fastForward = !fastForward;
     }
 }
 
 void EmulatorState::onKeyUp(State *state, const KeyPress &event) {
     if (event.keyCode == Common::Keys::A) {
-        sysio->keyup(event.shiftMod ? 'A' : 'a');
+        keyup(event.shiftMod ? 'A' : 'a');
     } else if (event.keyCode == Common::Keys::B) {
-        sysio->keyup(event.shiftMod ? 'B' : 'b');
+        keyup(event.shiftMod ? 'B' : 'b');
     } else if (event.keyCode == Common::Keys::C) {
-        sysio->keyup(event.shiftMod ? 'C' : 'c');
+        keyup(event.shiftMod ? 'C' : 'c');
     } else if (event.keyCode == Common::Keys::D) {
-        sysio->keyup(event.shiftMod ? 'D' : 'd');
+        keyup(event.shiftMod ? 'D' : 'd');
     } else if (event.keyCode == Common::Keys::E) {
-        sysio->keyup(event.shiftMod ? 'E' : 'e');
+        keyup(event.shiftMod ? 'E' : 'e');
     } else if (event.keyCode == Common::Keys::F) {
-        sysio->keyup(event.shiftMod ? 'F' : 'f');
+        keyup(event.shiftMod ? 'F' : 'f');
     } else if (event.keyCode == Common::Keys::G) {
-        sysio->keyup(event.shiftMod ? 'G' : 'g');
+        keyup(event.shiftMod ? 'G' : 'g');
     } else if (event.keyCode == Common::Keys::H) {
-        sysio->keyup(event.shiftMod ? 'H' : 'h');
+        keyup(event.shiftMod ? 'H' : 'h');
     } else if (event.keyCode == Common::Keys::I) {
-        sysio->keyup(event.shiftMod ? 'I' : 'i');
+        keyup(event.shiftMod ? 'I' : 'i');
     } else if (event.keyCode == Common::Keys::J) {
-        sysio->keyup(event.shiftMod ? 'J' : 'j');
+        keyup(event.shiftMod ? 'J' : 'j');
     } else if (event.keyCode == Common::Keys::K) {
-        sysio->keyup(event.shiftMod ? 'K' : 'k');
+        keyup(event.shiftMod ? 'K' : 'k');
     } else if (event.keyCode == Common::Keys::L) {
-        sysio->keyup(event.shiftMod ? 'L' : 'l');
+        keyup(event.shiftMod ? 'L' : 'l');
     } else if (event.keyCode == Common::Keys::M) {
-        sysio->keyup(event.shiftMod ? 'M' : 'm');
+        keyup(event.shiftMod ? 'M' : 'm');
     } else if (event.keyCode == Common::Keys::N) {
-        sysio->keyup(event.shiftMod ? 'N' : 'n');
+        keyup(event.shiftMod ? 'N' : 'n');
     } else if (event.keyCode == Common::Keys::O) {
-        sysio->keyup(event.shiftMod ? 'O' : 'o');
+        keyup(event.shiftMod ? 'O' : 'o');
     } else if (event.keyCode == Common::Keys::P) {
-        sysio->keyup(event.shiftMod ? 'P' : 'p');
+        keyup(event.shiftMod ? 'P' : 'p');
     } else if (event.keyCode == Common::Keys::Q) {
-        sysio->keyup(event.shiftMod ? 'Q' : 'q');
+        keyup(event.shiftMod ? 'Q' : 'q');
     } else if (event.keyCode == Common::Keys::R) {
-        sysio->keyup(event.shiftMod ? 'R' : 'r');
+        keyup(event.shiftMod ? 'R' : 'r');
     } else if (event.keyCode == Common::Keys::S) {
-        sysio->keyup(event.shiftMod ? 'S' : 's');
+        keyup(event.shiftMod ? 'S' : 's');
     } else if (event.keyCode == Common::Keys::T) {
-        sysio->keyup(event.shiftMod ? 'T' : 't');
+        keyup(event.shiftMod ? 'T' : 't');
     } else if (event.keyCode == Common::Keys::U) {
-        sysio->keyup(event.shiftMod ? 'U' : 'u');
+        keyup(event.shiftMod ? 'U' : 'u');
     } else if (event.keyCode == Common::Keys::V) {
-        sysio->keyup(event.shiftMod ? 'V' : 'v');
+        keyup(event.shiftMod ? 'V' : 'v');
     } else if (event.keyCode == Common::Keys::W) {
-        sysio->keyup(event.shiftMod ? 'W' : 'w');
+        keyup(event.shiftMod ? 'W' : 'w');
     } else if (event.keyCode == Common::Keys::X) {
-        sysio->keyup(event.shiftMod ? 'X' : 'x');
+        keyup(event.shiftMod ? 'X' : 'x');
     } else if (event.keyCode == Common::Keys::Y) {
-        sysio->keyup(event.shiftMod ? 'Y' : 'y');
+        keyup(event.shiftMod ? 'Y' : 'y');
     } else if (event.keyCode == Common::Keys::Z) {
-        sysio->keyup(event.shiftMod ? 'Z' : 'z');
+        keyup(event.shiftMod ? 'Z' : 'z');
     } else if (event.keyCode == Common::Keys::Num1) {
-        sysio->keyup(event.shiftMod ? '!' : '1');
+        keyup(event.shiftMod ? '!' : '1');
     } else if (event.keyCode == Common::Keys::Num2) {
-        sysio->keyup(event.shiftMod ? '@' : '2');
+        keyup(event.shiftMod ? '@' : '2');
     } else if (event.keyCode == Common::Keys::Num3) {
-        sysio->keyup(event.shiftMod ? '#' : '3');
+        keyup(event.shiftMod ? '#' : '3');
     } else if (event.keyCode == Common::Keys::Num4) {
-        sysio->keyup(event.shiftMod ? '$' : '4');
+        keyup(event.shiftMod ? '$' : '4');
     } else if (event.keyCode == Common::Keys::Num5) {
-        sysio->keyup(event.shiftMod ? '%' : '5');
+        keyup(event.shiftMod ? '%' : '5');
     } else if (event.keyCode == Common::Keys::Num6) {
-        sysio->keyup(event.shiftMod ? '^' : '6');
+        keyup(event.shiftMod ? '^' : '6');
     } else if (event.keyCode == Common::Keys::Num7) {
-        sysio->keyup(event.shiftMod ? '&' : '7');
+        keyup(event.shiftMod ? '&' : '7');
     } else if (event.keyCode == Common::Keys::Num8) {
-        sysio->keyup(event.shiftMod ? '*' : '8');
+        keyup(event.shiftMod ? '*' : '8');
     } else if (event.keyCode == Common::Keys::Num9) {
-        sysio->keyup(event.shiftMod ? '(' : '9');
+        keyup(event.shiftMod ? '(' : '9');
     } else if (event.keyCode == Common::Keys::Num0) {
-        sysio->keyup(event.shiftMod ? ')' : '0');
+        keyup(event.shiftMod ? ')' : '0');
     } else if (event.keyCode == Common::Keys::Backquote) {
-        sysio->keyup(event.shiftMod ? '~' : '`');
+        keyup(event.shiftMod ? '~' : '`');
     } else if (event.keyCode == Common::Keys::LBracket) {
-        sysio->keyup(event.shiftMod ? '{' : '[');
+        keyup(event.shiftMod ? '{' : '[');
     } else if (event.keyCode == Common::Keys::RBracket) {
-        sysio->keyup(event.shiftMod ? '}' : ']');
+        keyup(event.shiftMod ? '}' : ']');
     } else if (event.keyCode == Common::Keys::Semicolon) {
-        sysio->keyup(event.shiftMod ? ':' : ';');
+        keyup(event.shiftMod ? ':' : ';');
     } else if (event.keyCode == Common::Keys::Comma) {
-        sysio->keyup(event.shiftMod ? '<' : ',');
+        keyup(event.shiftMod ? '<' : ',');
     } else if (event.keyCode == Common::Keys::Period) {
-        sysio->keyup(event.shiftMod ? '>' : '.');
+        keyup(event.shiftMod ? '>' : '.');
     } else if (event.keyCode == Common::Keys::Quote) {
-        sysio->keyup(event.shiftMod ? '"' : '\'');
+        keyup(event.shiftMod ? '"' : '\'');
     } else if (event.keyCode == Common::Keys::Slash) {
-        sysio->keyup(event.shiftMod ? '?' : '/');
+        keyup(event.shiftMod ? '?' : '/');
     } else if (event.keyCode == Common::Keys::Backslash) {
-        sysio->keyup(event.shiftMod ? '|' : '\\');
+        keyup(event.shiftMod ? '|' : '\\');
     } else if (event.keyCode == Common::Keys::Equal) {
-        sysio->keyup(event.shiftMod ? '+' : '=');
+        keyup(event.shiftMod ? '+' : '=');
     } else if (event.keyCode == Common::Keys::Hyphen) {
-        sysio->keyup(event.shiftMod ? '_' : '-');
+        keyup(event.shiftMod ? '_' : '-');
     } else if (event.keyCode == Common::Keys::Enter) {
-        sysio->keyup('\n');
+        keyup('\n');
     } else if (event.keyCode == Common::Keys::Tab) {
-        sysio->keyup('\t');
+        keyup('\t');
     } else if (event.keyCode == Common::Keys::Space) {
-        sysio->keyup(' ');
+        keyup(' ');
     } else if (event.keyCode == Common::Keys::Backspace) {
-        sysio->keyup(8);
+        keyup(8);
    }
 }
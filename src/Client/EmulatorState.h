@@ -3,13 +3,32 @@
 
 #include <map>
 #include <queue>
+#include <deque>
 #include <optional>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+#ifdef _WIN32
+#include "mingw.thread.h"
+#else
+#include <thread>
+#endif
 
 #include "Common/Shared.h"
+#include "Common/Publisher.h"
+#include "Common/SPSCQueue.h"
+#include "Common/FramePacer.h"
+#include "Common/Palette.h"
+#include "Common/DirtyRows.h"
+#include "Client/Console.h"
 #include "Math/Point2.h"
 #include "Emulator/VM.h"
 #include "Emulator/Basic.h"
 #include "Client/BaseState.h"
+#include "Sys/Base.h"
+#include "Audio/Sequence.h"
+#include "Audio/Sample.h"
 
 namespace Client {
     class State;
@@ -27,11 +46,12 @@ namespace Client {
         uint8_t decay;
         uint8_t sustain;
         uint8_t release;
+        uint8_t pan;
 
-        VoiceConfig() : waveForm(0), volume(255), attack(0), decay(0), sustain(255), release(0) {
+        VoiceConfig() : waveForm(0), volume(255), attack(0), decay(0), sustain(255), release(0), pan(128) {
         }
 
-        VoiceConfig(uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) : waveForm(waveForm), volume(volume), attack(attack), decay(decay), sustain(sustain), release(release) {
+        VoiceConfig(uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) : waveForm(waveForm), volume(volume), attack(attack), decay(decay), sustain(sustain), release(release), pan(pan) {
         }
     };
 
@@ -41,22 +61,44 @@ namespace Client {
         uint16_t duration;
         VoiceConfig voiceConfig;
 
-        SoundBufferObject(uint8_t voice, float frequency, uint16_t duration, VoiceConfig voiceConfig) : voice(voice), frequency(frequency), duration(duration), voiceConfig(voiceConfig) {
+        // Set for a PLAY tune instead of a single note, it starts delay
+        // samples after the sound's time
+        std::shared_ptr<const Audio::Sequence> sequence;
+        uint32_t delay;
+
+        // Set for PCM, played with frequency as its sample rate
+        std::shared_ptr<const Audio::Sample> sample;
+
+        SoundBufferObject(uint8_t voice, float frequency, uint16_t duration, VoiceConfig voiceConfig) : voice(voice), frequency(frequency), duration(duration), voiceConfig(voiceConfig), delay(0) {
+        }
+
+        SoundBufferObject(uint8_t voice, std::shared_ptr<const Audio::Sequence> sequence, uint32_t delay, VoiceConfig voiceConfig) : voice(voice), frequency(0.0f), duration(0), voiceConfig(voiceConfig), sequence(sequence), delay(delay) {
+        }
+
+        SoundBufferObject(uint8_t voice, std::shared_ptr<const Audio::Sample> sample, float rate, VoiceConfig voiceConfig) : voice(voice), frequency(rate), duration(0), voiceConfig(voiceConfig), delay(0), sample(sample) {
         }
     };
 
 
+    struct Frame;
+
     class SystemIO : public Emulator::SysIO {
         public:
             const static int32_t Width = 320;
             const static int32_t Height = 240;
-        private:
+
             const static int32_t chars = 40;
             const static int32_t lines = 30;
 
+            typedef Console<chars, lines> Text;
+        private:
+
             Point cursor;
 
-            std::vector<std::array<char, chars+1>> screenbuffer;
+            Text console;
+            // Background at the last cls, cells still showing it are
+            // left transparent over the pixel layer
+            uint8_t clearBackground;
             std::array<uint8_t, Width*Height> screen;
 
             std::queue<char> inputBuffer;
@@ -72,6 +114,21 @@ namespace Client {
 
             std::array<VoiceConfig, VOICE_COUNT> voices;
 
+            // Tunes queued by PLAY on each voice, back to back from the
+            // sample they start at. The mixers follow the same schedule,
+            // so the notes left can be counted here.
+            struct Tune {
+                uint64_t start;
+                std::shared_ptr<const Audio::Sequence> sequence;
+            };
+
+            std::array<std::deque<Tune>, VOICE_COUNT> tunes;
+
+            // Defined by SAMPLE, shared as they are by every PCM
+            std::array<std::shared_ptr<const Audio::Sample>, 256> samples;
+
+            void expireTunes(uint8_t voice, uint64_t now);
+
             uint64_t nextKeyId;
             std::array<uint64_t, 256> keysPressed;
 
@@ -79,6 +136,15 @@ namespace Client {
             uint16_t mouseButtons = 0;
 
             uint32_t time = 0;
+
+            // Changes since the last snapshot, handed over with it
+            uint64_t sequence;
+            Common::DirtyRows<Height> dirtyPixels;
+            Common::DirtyRows<lines> dirtyText;
+
+            void markText(size_t line, uint16_t column) {
+                dirtyText.mark(line, column, column + 1);
+            }
         public:
             SystemIO();
 
@@ -106,8 +172,8 @@ namespace Client {
 
             std::string gets();
 
-            std::vector<std::array<char, chars+1>> getScreenBuffer() {
-                return screenbuffer;
+            const Text &text() const {
+                return console;
             }
 
             void buffer(char c) {
@@ -131,8 +197,10 @@ namespace Client {
             void mouseup(const MouseClick &click);
 
             void palette(uint8_t id) {
-                if (id < palettes.size()) {
+                if (id < palettes.size() && id != currentPalette) {
                     currentPalette = id;
+                    dirtyPixels.markAll(Width);
+                    dirtyText.markAll(chars);
                 }
             }
 
@@ -155,9 +223,13 @@ namespace Client {
             void blit(uint16_t x, uint16_t y, std::vector<uint8_t> buffer);
 
             void sound(uint8_t voice, float frequency, uint16_t duration);
-            void voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release);
+            void voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            bool play(uint8_t voice, const std::string &tune);
+            uint16_t playing(uint8_t voice);
+            void sample(uint8_t id, std::vector<int16_t> pcm, uint32_t loopStart, uint32_t loopEnd);
+            void pcm(uint8_t voice, uint8_t id, float rate);
 
-            std::array<Common::Colour, 256> getCurrentPalette() {
+            const std::array<Common::Colour, 256> &getCurrentPalette() const {
                 return palettes[currentPalette];
             }
 
@@ -169,7 +241,7 @@ namespace Client {
                 return palettes[currentPalette][background];
             }
 
-            std::array<uint8_t, Width*Height> getScreen() {
+            const std::array<uint8_t, Width*Height> &getScreen() const {
                 return screen;
             }
 
@@ -182,9 +254,61 @@ namespace Client {
                 return sound;
             }
 
-            VoiceConfig getVoice(const uint8_t voice) {
+            const VoiceConfig &getVoice(const uint8_t voice) const {
                 return voices[voice];
             }
+
+            bool changed() const {
+                return !dirtyPixels.empty() || !dirtyText.empty();
+            }
+
+            // Copies the current state into frame along with what changed
+            // since the previous snapshot, then starts tracking afresh.
+            void snapshot(Frame &frame);
+    };
+
+    // Everything a renderer or recorder needs to show one frame. Frames
+    // are published immutable and shared, never copied out.
+    struct Frame {
+        // Increases by one per published frame, a gap means frames were
+        // missed and the dirty sets below no longer cover every change.
+        uint64_t sequence;
+        Common::DirtyRows<SystemIO::Height> dirtyPixels;
+        Common::DirtyRows<SystemIO::lines> dirtyText;
+
+        // Emulated milliseconds when the frame was taken
+        uint32_t time;
+
+        std::array<uint8_t, SystemIO::Width*SystemIO::Height> screen;
+        std::array<Common::Colour, 256> palette;
+        SystemIO::Text text;
+        uint8_t clearBackground;
+        int32_t fontSize;
+        Point cursor;
+    };
+
+    typedef std::function<void(const std::shared_ptr<const Frame> &frame)> FrameListener;
+
+    // Called with the emulated time each sound was started at
+    typedef std::function<void(uint32_t time, const SoundBufferObject &sound)> SoundListener;
+
+    // Draws the text layer of frame, backgrounds then characters, over
+    // whatever the renderer already holds.
+    void DrawText(const Frame &frame, Renderer::Base &renderer);
+
+    struct InputEvent {
+        enum class Type {
+            KeyDown,
+            KeyUp,
+            MouseMove,
+            MouseDown,
+            MouseUp
+        };
+
+        Type type;
+        char key;
+        Point position;
+        MouseClick click;
     };
 
     class EmulatorState : public BaseState {
@@ -196,11 +320,146 @@ namespace Client {
 
             std::map<uint32_t, std::vector<Emulator::BasicToken>> basic;
             const bool debug;
+
+            // Completed frames flow from the emulation thread to the
+            // render thread and any listeners, input events flow the
+            // other way.
+            Common::Publisher<Frame> frames;
+            std::vector<FrameListener> listeners;
+            std::vector<SoundListener> soundListeners;
+            Common::SPSCQueue<InputEvent, 256> input;
+
+            // Latest frame expanded to RGBA, only the rows that changed
+            // are redone. Owned by the render thread.
+            std::shared_ptr<const Frame> shown;
+            Common::PaletteTable paletteTable;
+            std::array<uint32_t, SystemIO::Width*SystemIO::Height> rgba;
+            Renderer::Base::Bands bands;
+            uint64_t presented;
+            bool fresh;
+            bool redraw;
+
+            // Set once the program stops, the prompt runs until the
+            // next RUN or immediate command
+            std::atomic<bool> halted;
+
+            const bool threaded;
+            std::thread worker;
+            std::atomic<bool> running;
+            std::atomic<bool> paused;
+            std::atomic<bool> idle;
+            std::shared_ptr<Sys::Base> sys;
+
+            Common::FramePacer pacer;
+
+            // Fast-forward runs slices back to back, presenting every
+            // frameskip'th slice or, when zero, one per display period.
+            std::atomic<bool> fastForward;
+            const uint32_t frameskip;
+            uint32_t skipped;
+            int64_t nextPresent;
+
+            // Single threaded, tick time not yet emulated. Capped so a
+            // stalled host drops time rather than running a burst.
+            constexpr static int64_t MaxBacklog = 100000000;
+            int64_t backlog;
+
+            // Emulated time per host time, sampled over SpeedWindow.
+            const static int64_t SpeedWindow = 500000000;
+            int64_t speedStart;
+            int64_t emulated;
+            std::atomic<double> speed;
+            std::atomic<double> peak;
+
+            // Optional governor scaling the cycle budget between
+            // minBudget and maxBudget so a slice fits in GovernorTarget
+            // of the frame period.
+            constexpr static double GovernorTarget = 0.75;
+            const bool governed;
+            const uint32_t minBudget;
+            const uint32_t maxBudget;
+            std::atomic<uint32_t> budget;
+            double costPerCycle;
+
+            void keydown(char key);
+            void keyup(char key);
+
+            void processInput();
+            void tick(const uint32_t time);
+            void step(const uint32_t time, bool present=true);
+            void measure(int64_t slice);
+            void govern(int64_t elapsed, uint64_t cycles);
+            bool present();
+            void emulate();
         public:
-            EmulatorState(std::shared_ptr<Emulator::VM> vm, std::shared_ptr<Emulator::Program> program, uint32_t clockspeed, bool debug) : vm(vm), program(program), clockspeed(clockspeed), debug(debug) {
+            EmulatorState(std::shared_ptr<Emulator::VM> vm, std::shared_ptr<Emulator::Program> program, uint32_t clockspeed, bool debug, bool threaded, bool fastForward=false, uint32_t frameskip=0, uint32_t minBudget=0, uint32_t maxBudget=0) : vm(vm), program(program), clockspeed(clockspeed), debug(debug), presented(0), fresh(false), redraw(true), halted(false), threaded(threaded), running(false), paused(false), idle(false), fastForward(fastForward), frameskip(frameskip), skipped(0), nextPresent(0), backlog(0), speedStart(Common::FramePacer::Now()), emulated(0), speed(1.0), peak(1.0), governed(minBudget && maxBudget), minBudget(minBudget), maxBudget(maxBudget), budget(minBudget && maxBudget ? std::clamp(clockspeed, minBudget, maxBudget) : clockspeed), costPerCycle(0.0) {
                 sysio = std::make_shared<SystemIO>();
+                sysio->snapshot(frames.write());
+                frames.publish();
+            }
+
+            ~EmulatorState() {
+                stop();
+            }
+
+            void stop();
+
+            const Common::FramePacer &Pacer() const {
+                return pacer;
+            }
+
+            // Latest published frame, safe to call from any thread
+            std::shared_ptr<const Frame> latestFrame() const {
+                return frames.latest();
+            }
+
+            // Listeners are called on the emulation thread with every
+            // published frame, so should only queue it for later. They
+            // have to be added before the first tick.
+            void addFrameListener(FrameListener listener) {
+                listeners.push_back(listener);
+            }
+
+            bool Halted() const {
+                return halted;
+            }
+
+            // Emulated milliseconds run so far. Only read it from the
+            // emulation thread or once it has stopped.
+            uint32_t Clock() const {
+                return sysio->clock();
             }
 
+            // As with frame listeners, called on the emulation thread and
+            // added before the first tick.
+            void addSoundListener(SoundListener listener) {
+                soundListeners.push_back(listener);
+            }
+
+            bool FastForward() const {
+                return fastForward;
+            }
+
+            void setFastForward(bool enabled) {
+                fastForward = enabled;
+            }
+
+            // Achieved speed as a multiple of the selected clock
+            double Speed() const {
+                return speed;
+            }
+
+            double MHz() const {
+                return (double)clockspeed * 60.0 / 1000000.0;
+            }
+
+            // Clock speed the governor has currently settled on
+            double EffectiveMHz() const {
+                return (double)budget * 60.0 / 1000000.0;
+            }
+
+            std::string report() const;
+
             void onRender(State *state, const uint32_t time);
             void onTick(State *state, const uint32_t time);
             void onMouseMove(State *state, const MouseMove &event);
@@ -209,13 +468,10 @@ namespace Client {
             void onKeyDown(State *state, const KeyPress &event);
             void onKeyUp(State *state, const KeyPress &event);
 
-            void onEnterState(State *state, std::any data) {
-                //sysio->cls();
-            }
+            void onEnterState(State *state, std::any data);
+            void onLeaveState(State *state, std::any data);
 
-            void onLeaveState(State *state, std::any data) {
-                //sysio->cls();
-            }
+            bool needsRender(State *state);
     };
 };
 
@@ -0,0 +1,89 @@
+#include "Client/FrameExport.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <iostream>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Client;
+
+FrameExport::FrameExport(const std::string &name) : name(name), fd(-1), shared(nullptr), last(0) {
+    fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+
+    if (fd < 0 || ftruncate(fd, sizeof(SharedFrame)) != 0) {
+        std::cerr << "Could not create shared memory `" << name << "': " << strerror(errno) << std::endl;
+        exit(-1);
+    }
+
+    void *mapped = mmap(nullptr, sizeof(SharedFrame), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Could not map shared memory `" << name << "': " << strerror(errno) << std::endl;
+        exit(-1);
+    }
+
+    shared = new (mapped) SharedFrame();
+
+    std::memcpy(shared->magic, "GRAPEFB", 8);
+    shared->version = SharedFrame::Version;
+    shared->width = SystemIO::Width;
+    shared->height = SystemIO::Height;
+    shared->columns = SystemIO::chars;
+    shared->rows = SystemIO::lines;
+    shared->sequence.store(0, std::memory_order_release);
+}
+
+FrameExport::~FrameExport() {
+    if (shared)
+        munmap(shared, sizeof(SharedFrame));
+
+    if (fd >= 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+    }
+}
+
+void FrameExport::publish(const Frame &frame) {
+    // Listeners see every frame, so the dirty sets are complete unless
+    // this is the first one.
+    bool full = last == 0 || frame.sequence != last + 1;
+    last = frame.sequence;
+
+    uint64_t sequence = shared->sequence.load(std::memory_order_relaxed);
+    shared->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    shared->frame++;
+    shared->time = frame.time;
+    shared->cursorX = frame.cursor.X();
+    shared->cursorY = frame.cursor.Y();
+
+    for (size_t i = 0; i < frame.palette.size(); i++) {
+        shared->palette[i][0] = frame.palette[i].R();
+        shared->palette[i][1] = frame.palette[i].G();
+        shared->palette[i][2] = frame.palette[i].B();
+        shared->palette[i][3] = frame.palette[i].A();
+    }
+
+    for (int32_t y = 0; y < SystemIO::Height; y++) {
+        if (full) {
+            std::memcpy(shared->screen + y * SystemIO::Width, frame.screen.data() + y * SystemIO::Width, SystemIO::Width);
+        } else if (frame.dirtyPixels.isDirty(y)) {
+            size_t offset = y * SystemIO::Width + frame.dirtyPixels.First(y);
+            std::memcpy(shared->screen + offset, frame.screen.data() + offset, frame.dirtyPixels.Last(y) - frame.dirtyPixels.First(y));
+        }
+    }
+
+    // Text is laid out top row first, whatever the console has scrolled
+    for (int32_t y = 0; y < SystemIO::lines; y++) {
+        if (full || frame.dirtyText.isDirty(y))
+            std::memcpy(shared->text + y * SystemIO::chars, frame.text.row(y), SystemIO::chars * sizeof(Cell));
+    }
+
+    shared->sequence.store(sequence + 2, std::memory_order_release);
+}
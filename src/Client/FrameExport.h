@@ -0,0 +1,65 @@
+#ifndef __CLIENT_FRAMEEXPORT_H__
+#define __CLIENT_FRAMEEXPORT_H__
+
+#include <cstdint>
+#include <string>
+#include <atomic>
+
+#include "Client/EmulatorState.h"
+
+namespace Client {
+    // Layout of the shared memory segment, fixed so other programs can
+    // map it. Readers follow the seqlock on sequence, which is odd while
+    // the emulator is writing:
+    //
+    //   do {
+    //       s1 = sequence.load(acquire);  // retry while odd
+    //       copy what is needed
+    //       atomic_thread_fence(acquire);
+    //       s2 = sequence.load(relaxed);
+    //   } while (s1 != s2 || s1 & 1);
+    struct SharedFrame {
+        const static uint32_t Version = 1;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t columns;
+        uint32_t rows;
+
+        std::atomic<uint64_t> sequence;
+
+        // Number of frames published, and emulated milliseconds at the last
+        uint64_t frame;
+        uint32_t time;
+
+        int32_t cursorX;
+        int32_t cursorY;
+
+        // Palette entries as R, G, B, A bytes
+        uint8_t palette[256][4];
+        uint8_t screen[SystemIO::Width * SystemIO::Height];
+        Cell text[SystemIO::lines * SystemIO::chars];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "SharedFrame needs a lock-free sequence");
+
+    // Mirrors every published frame into a POSIX shared memory segment.
+    // Only rows that changed are copied, readers never block the writer.
+    class FrameExport {
+            const std::string name;
+            int fd;
+            SharedFrame *shared;
+            uint64_t last;
+        public:
+            // name is a shm_open() name such as /grape16
+            FrameExport(const std::string &name);
+            ~FrameExport();
+
+            // Called from the emulation thread as a frame listener
+            void publish(const Frame &frame);
+    };
+};
+
+#endif //__CLIENT_FRAMEEXPORT_H__
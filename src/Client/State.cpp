@@ -28,6 +28,10 @@ void State::tick(const uint32_t time) {
     currentState->onTick(this, time);
 }
 
+bool State::needsRender() {
+    return currentState->needsRender(this);
+}
+
 void State::mouseMove(const MouseMove &event) {
     currentState->onMouseMove(this, event);
 }
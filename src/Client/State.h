@@ -29,6 +29,7 @@ namespace Client {
         // Event dispatch
         void render(const uint32_t time);
         void tick(const uint32_t time);
+        bool needsRender();
         void mouseMove(const MouseMove &event);
         void mouseButtonPress(const MouseClick &event);
         void mouseButtonRelease(const MouseClick &event);
@@ -0,0 +1,81 @@
+#ifndef __COMMON_DIRTYROWS_H__
+#define __COMMON_DIRTYROWS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <algorithm>
+
+namespace Common {
+    // Tracks which columns of each row of a grid changed, as a single
+    // [first, last) span per row.
+    template <size_t Rows> class DirtyRows {
+        private:
+            std::array<uint16_t, Rows> first;
+            std::array<uint16_t, Rows> last;
+            bool dirty;
+        public:
+            DirtyRows() {
+                clear();
+            }
+
+            void mark(size_t row, uint16_t from, uint16_t to) {
+                if (row >= Rows || from >= to)
+                    return;
+
+                first[row] = std::min(first[row], from);
+                last[row] = std::max(last[row], to);
+                dirty = true;
+            }
+
+            void markAll(uint16_t width) {
+                first.fill(0);
+                last.fill(width);
+                dirty = true;
+            }
+
+            void clear() {
+                first.fill(UINT16_MAX);
+                last.fill(0);
+                dirty = false;
+            }
+
+            bool empty() const {
+                return !dirty;
+            }
+
+            bool isDirty(size_t row) const {
+                return last[row] != 0;
+            }
+
+            uint16_t First(size_t row) const {
+                return first[row];
+            }
+
+            uint16_t Last(size_t row) const {
+                return last[row];
+            }
+
+            // Calls f(top, count) for every run of consecutive dirty rows.
+            template <typename F> void forEachBand(F f) const {
+                if (!dirty)
+                    return;
+
+                size_t row = 0;
+                while (row < Rows) {
+                    if (!isDirty(row)) {
+                        row++;
+                        continue;
+                    }
+
+                    size_t top = row;
+                    while (row < Rows && isDirty(row))
+                        row++;
+
+                    f(top, row - top);
+                }
+            }
+    };
+}; // namespace Common
+
+#endif //__COMMON_DIRTYROWS_H__
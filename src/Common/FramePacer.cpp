@@ -0,0 +1,125 @@
+#include "Common/FramePacer.h"
+
+#ifdef _WIN32
+#include "mingw.thread.h"
+#else
+#include <thread>
+#endif
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+using namespace Common;
+
+FramePacer::FramePacer(double rate) {
+    setRate(rate);
+}
+
+void FramePacer::setRate(double rate) {
+    if (rate <= 0.0)
+        rate = 60.0;
+
+    this->rate = rate;
+    period = (int64_t)(1000000000.0 / rate);
+
+    reset();
+}
+
+void FramePacer::reset() {
+    resync();
+    carry = 0;
+
+    frames = 0;
+    late = 0;
+    mean = 0.0;
+    m2 = 0.0;
+    shortest = std::numeric_limits<int64_t>::max();
+    longest = 0;
+}
+
+void FramePacer::resync() {
+    lastFrame = Now();
+    deadline = lastFrame + period;
+}
+
+void FramePacer::record(int64_t interval) {
+    frames++;
+
+    double delta = (double)interval - mean;
+    mean += delta / (double)frames;
+    m2 += delta * ((double)interval - mean);
+
+    shortest = std::min(shortest, interval);
+    longest = std::max(longest, interval);
+}
+
+int64_t FramePacer::wait() {
+    int64_t now = Now();
+
+    if (now > deadline + period) {
+        // More than a whole frame behind, catching up would only produce
+        // a burst of short frames so drop the missed deadlines instead.
+        late++;
+        deadline = now;
+    } else {
+        int64_t remaining = deadline - now;
+
+        if (remaining > SpinThreshold)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - SpinThreshold));
+
+        while ((now = Now()) < deadline)
+            std::this_thread::yield();
+    }
+
+    // Deadlines advance by whole periods from where they were due, not
+    // from when we woke up, so oversleeping does not accumulate drift.
+    deadline += period;
+
+    int64_t elapsed = now - lastFrame;
+    lastFrame = now;
+
+    record(elapsed);
+
+    return elapsed;
+}
+
+uint32_t FramePacer::elapsedMilliseconds(int64_t elapsed) {
+    carry += elapsed;
+
+    int64_t ms = carry / 1000000;
+    carry -= ms * 1000000;
+
+    return (uint32_t)ms;
+}
+
+double FramePacer::MeanInterval() const {
+    return mean;
+}
+
+double FramePacer::Jitter() const {
+    if (frames < 2)
+        return 0.0;
+
+    return std::sqrt(m2 / (double)(frames - 1));
+}
+
+std::string FramePacer::report(const std::string &name) const {
+    std::ostringstream s;
+
+    s << std::fixed << std::setprecision(3);
+    s << name << ": " << frames << " frames @ " << rate << "Hz";
+
+    if (frames) {
+        s << ", mean " << mean / 1000000.0 << "ms";
+        s << ", jitter " << Jitter() / 1000000.0 << "ms";
+        s << ", min " << shortest / 1000000.0 << "ms";
+        s << ", max " << longest / 1000000.0 << "ms";
+    }
+
+    s << ", late " << late;
+
+    return s.str();
+}
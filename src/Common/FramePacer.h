@@ -0,0 +1,79 @@
+#ifndef __COMMON_FRAMEPACER_H__
+#define __COMMON_FRAMEPACER_H__
+
+#include <cstdint>
+#include <chrono>
+#include <string>
+
+namespace Common {
+    class FramePacer {
+        public:
+            typedef std::chrono::steady_clock Clock;
+        private:
+            // Sleep until this close to the deadline, then spin the rest.
+            const static int64_t SpinThreshold = 2000000;
+
+            double rate;
+            int64_t period;
+
+            int64_t deadline;
+            int64_t lastFrame;
+
+            // Sub-millisecond time left over from elapsedMilliseconds()
+            int64_t carry;
+
+            uint64_t frames;
+            uint64_t late;
+            double mean;
+            double m2;
+            int64_t shortest;
+            int64_t longest;
+
+            void record(int64_t interval);
+        public:
+            FramePacer(double rate=60.0);
+
+            static int64_t Now() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+            }
+
+            double Rate() const {
+                return rate;
+            }
+
+            int64_t Period() const {
+                return period;
+            }
+
+            void setRate(double rate);
+
+            // Clears statistics and restarts the frame schedule.
+            void reset();
+
+            // Restarts the frame schedule from now, e.g. after a pause.
+            void resync();
+
+            // Blocks until the next frame deadline and returns the number
+            // of nanoseconds since the previous call returned.
+            int64_t wait();
+
+            // Converts a nanosecond delta to whole milliseconds, keeping
+            // the remainder so no time is lost between frames.
+            uint32_t elapsedMilliseconds(int64_t elapsed);
+
+            uint64_t Frames() const {
+                return frames;
+            }
+
+            uint64_t Late() const {
+                return late;
+            }
+
+            double MeanInterval() const;
+            double Jitter() const;
+
+            std::string report(const std::string &name) const;
+    };
+}; // namespace Common
+
+#endif //__COMMON_FRAMEPACER_H__
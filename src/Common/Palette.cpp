@@ -0,0 +1,83 @@
+#include "Common/Palette.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(__EMSCRIPTEN__)
+#define PALETTE_AVX2 1
+#include <immintrin.h>
+#endif
+
+using namespace Common;
+
+void Common::PaletteToRGBA(const std::array<Colour, 256> &palette, PaletteTable &table) {
+    for (size_t i = 0; i < palette.size(); i++) {
+        table[i] = palette[i].RGBA();
+    }
+}
+
+void Common::ExpandPaletteScalar(const uint8_t *pixels, const PaletteTable &table, uint32_t *rgba, size_t count) {
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        rgba[i+0] = table[pixels[i+0]];
+        rgba[i+1] = table[pixels[i+1]];
+        rgba[i+2] = table[pixels[i+2]];
+        rgba[i+3] = table[pixels[i+3]];
+    }
+
+    for (; i < count; i++) {
+        rgba[i] = table[pixels[i]];
+    }
+}
+
+#ifdef PALETTE_AVX2
+__attribute__((target("avx2")))
+static void expandAVX2(const uint8_t *pixels, const uint32_t *table, uint32_t *rgba, size_t count) {
+    size_t i = 0;
+
+    // Widen 8 indices at a time to 32 bits and gather their colours.
+    for (; i + 16 <= count; i += 16) {
+        __m128i packed = _mm_loadu_si128((const __m128i *)(pixels + i));
+
+        __m256i low = _mm256_cvtepu8_epi32(packed);
+        __m256i high = _mm256_cvtepu8_epi32(_mm_srli_si128(packed, 8));
+
+        _mm256_storeu_si256((__m256i *)(rgba + i), _mm256_i32gather_epi32((const int *)table, low, 4));
+        _mm256_storeu_si256((__m256i *)(rgba + i + 8), _mm256_i32gather_epi32((const int *)table, high, 4));
+    }
+
+    for (; i < count; i++) {
+        rgba[i] = table[pixels[i]];
+    }
+}
+
+static bool hasAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+bool Common::ExpandPaletteAVX2(const uint8_t *pixels, const PaletteTable &table, uint32_t *rgba, size_t count) {
+#ifdef PALETTE_AVX2
+    if (hasAVX2()) {
+        expandAVX2(pixels, table.data(), rgba, count);
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+void Common::ExpandPalette(const uint8_t *pixels, const PaletteTable &table, uint32_t *rgba, size_t count) {
+    if (ExpandPaletteAVX2(pixels, table, rgba, count))
+        return;
+
+    ExpandPaletteScalar(pixels, table, rgba, count);
+}
+
+const char *Common::PaletteKernel() {
+#ifdef PALETTE_AVX2
+    if (hasAVX2())
+        return "avx2";
+#endif
+
+    return "scalar";
+}
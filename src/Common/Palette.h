@@ -0,0 +1,28 @@
+#ifndef __COMMON_PALETTE_H__
+#define __COMMON_PALETTE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+#include "Common/Colour.h"
+
+namespace Common {
+    typedef std::array<uint32_t, 256> PaletteTable;
+
+    // Packs a palette into the RGBA words the expansion kernels look up.
+    void PaletteToRGBA(const std::array<Colour, 256> &palette, PaletteTable &table);
+
+    // Expands count indexed pixels into RGBA through table, using the
+    // fastest kernel the host CPU supports.
+    void ExpandPalette(const uint8_t *pixels, const PaletteTable &table, uint32_t *rgba, size_t count);
+
+    // Individual kernels, exposed for benchmarking.
+    void ExpandPaletteScalar(const uint8_t *pixels, const PaletteTable &table, uint32_t *rgba, size_t count);
+    bool ExpandPaletteAVX2(const uint8_t *pixels, const PaletteTable &table, uint32_t *rgba, size_t count);
+
+    // Name of the kernel ExpandPalette() dispatches to.
+    const char *PaletteKernel();
+}; // namespace Common
+
+#endif //__COMMON_PALETTE_H__
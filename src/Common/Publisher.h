@@ -0,0 +1,69 @@
+#ifndef __COMMON_PUBLISHER_H__
+#define __COMMON_PUBLISHER_H__
+
+#include <memory>
+#include <vector>
+#include <atomic>
+
+namespace Common {
+    // Hands immutable snapshots from one producer thread to any number of
+    // readers. Readers share the published object rather than copying it,
+    // and the producer recycles objects once no reader holds them.
+    template <typename T> class Publisher {
+        private:
+            // Producer only
+            std::vector<std::shared_ptr<T>> pool;
+            std::shared_ptr<T> pending;
+
+            // Only ever accessed through std::atomic_load/atomic_store
+            std::shared_ptr<const T> current;
+        public:
+            Publisher() {
+            }
+
+            Publisher(const Publisher &) = delete;
+            Publisher &operator=(const Publisher &) = delete;
+
+            // Returns an object no reader can see to fill in. Its previous
+            // contents are whatever was published in it last.
+            T &write() {
+                if (pending)
+                    return *pending;
+
+                std::shared_ptr<const T> published = std::atomic_load(&current);
+
+                for (auto &candidate : pool) {
+                    // The pool's own reference is the only one left, and
+                    // readers can only gain new ones through current.
+                    if (candidate.use_count() == 1 && candidate != published) {
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        pending = candidate;
+                        return *pending;
+                    }
+                }
+
+                pending = std::make_shared<T>();
+                pool.push_back(pending);
+
+                return *pending;
+            }
+
+            // Makes the object from write() the current one.
+            std::shared_ptr<const T> publish() {
+                std::shared_ptr<const T> published = pending;
+
+                std::atomic_store(&current, published);
+                pending.reset();
+
+                return published;
+            }
+
+            // The most recently published object, or empty before the
+            // first publish(). Safe to call from any thread.
+            std::shared_ptr<const T> latest() const {
+                return std::atomic_load(&current);
+            }
+    };
+}; // namespace Common
+
+#endif //__COMMON_PUBLISHER_H__
@@ -0,0 +1,57 @@
+#ifndef __COMMON_SPSCQUEUE_H__
+#define __COMMON_SPSCQUEUE_H__
+
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <utility>
+
+namespace Common {
+    // Bounded lock-free queue for exactly one producer thread and one
+    // consumer thread. Capacity must be a power of two.
+    template <typename T, size_t Capacity> class SPSCQueue {
+        static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+        private:
+            std::array<T, Capacity> ring;
+
+            alignas(64) std::atomic<size_t> head;
+            alignas(64) std::atomic<size_t> tail;
+        public:
+            SPSCQueue() : head(0), tail(0) {
+            }
+
+            SPSCQueue(const SPSCQueue &) = delete;
+            SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+            bool push(const T &item) {
+                size_t t = tail.load(std::memory_order_relaxed);
+
+                if (t - head.load(std::memory_order_acquire) == Capacity)
+                    return false;
+
+                ring[t & (Capacity - 1)] = item;
+                tail.store(t + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            bool pop(T &item) {
+                size_t h = head.load(std::memory_order_relaxed);
+
+                if (h == tail.load(std::memory_order_acquire))
+                    return false;
+
+                item = std::move(ring[h & (Capacity - 1)]);
+                head.store(h + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            bool empty() const {
+                return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+            }
+    };
+}; // namespace Common
+
+#endif //__COMMON_SPSCQUEUE_H__
@@ -6,17 +6,27 @@
 #include <string>
 #include <cmath>
 
+#ifndef HEADLESS
 #ifdef __MACOSX__
 #include <gl.h>
 //#include <glu.h>
 #else
 #include <GL/gl.h>
 #endif
+#endif
 
 #ifndef M_PI
 #define M_PI            3.14159265358979323846
 #endif
 
+#ifndef M_PI_2
+#define M_PI_2          1.57079632679489661923
+#endif
+
+#ifndef M_SQRT2
+#define M_SQRT2         1.41421356237309504880
+#endif
+
 #define ANG2RAD (M_PI/180.0)
 
 #define mathPiDiv180 (M_PI/180)
@@ -36,6 +46,8 @@ typedef vecf vec4f[4];
 #include <random>
 typedef std::mt19937 RngT;
 
-#define VOICE_COUNT 4
+// Channels SOUND and VOICE address, the notes themselves play from
+// the pool of voices in Audio::Mixer
+#define VOICE_COUNT 16
 
 #endif //__COMMON_SHARED_H__
@@ -206,6 +206,14 @@ std::pair<SysCall, RuntimeValue> getSysCall(uint32_t linenumber, const std::stri
         syscall = SysCall::MOUSE;
     } else if (syscallname == "CLOCK") {
         syscall = SysCall::CLOCK;
+    } else if (syscallname == "PLAY") {
+        syscall = SysCall::PLAY;
+    } else if (syscallname == "PLAYING") {
+        syscall = SysCall::PLAYING;
+    } else if (syscallname == "SAMPLE") {
+        syscall = SysCall::SAMPLE;
+    } else if (syscallname == "PCM") {
+        syscall = SysCall::PCM;
     } else {
         error(linenumber, opcode, "Unknown SysCall");
     }
@@ -263,6 +271,14 @@ std::pair<std::string, std::string> getSysCall(SysCall syscall, RuntimeValue rt)
         syscallname = "MOUSE";
     } else if (syscall == SysCall::CLOCK) {
         syscallname = "CLOCK";
+    } else if (syscall == SysCall::PLAY) {
+        syscallname = "PLAY";
+    } else if (syscall == SysCall::PLAYING) {
+        syscallname = "PLAYING";
+    } else if (syscall == SysCall::SAMPLE) {
+        syscallname = "SAMPLE";
+    } else if (syscall == SysCall::PCM) {
+        syscallname = "PCM";
     } else {
         throw std::domain_error("Unknown SysCall");
     }
@@ -9,6 +9,20 @@ using namespace Emulator;
 #include <stack>
 #include <variant>
 
+#ifdef _WIN32
+#include "mingw.thread.h"
+#else
+#include <thread>
+#endif
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define MAP_SOURCE
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #define READ_INDEX "DATA"
 #define FRAME_INDEX "FRAME"
 
@@ -18,117 +32,184 @@ using namespace Emulator;
 #define LINE_INDEX "LINE"
 #define LINE_ARGS 6
 
-static void error(uint32_t linenumber, const std::string &err);
+#define SAMPLE_INDEX "SAMPLE"
+#define SAMPLE_ARGS 5
 
-struct UserFunction {
-    uint32_t call;
-    std::vector<std::string> args;
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
 
-    UserFunction(uint32_t call, std::vector<std::string> args) {
-        this->call = call;
-        this->args = args;
-    }
+static bool isAlpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool isWhitespace(char c) {
+    return (c == ' ') || (c == '\t');
+}
+
+static constexpr char upper(char c) {
+    return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+}
+
+struct Keyword {
+    const char *name;
+    size_t length;
+    BasicTokenType type;
+    Precedence precedence;
 };
 
-class Environment {
-    private:
-        std::map<const std::string, uint32_t> vars;
-        std::shared_ptr<Environment> parent;
-        const uint32_t offset;
-    public:
-        Environment(uint32_t offset) : parent(NULL), offset(offset) {
-        }
+static constexpr Keyword Keywords[] = {
+    {"ABS", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"AND", 3, BasicTokenType::AND, Precedence::AND},
+    {"ATAN", 4, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"BEEP", 4, BasicTokenType::BEEP, Precedence::NONE},
+    {"CHR", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"CINT", 4, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"CLS", 3, BasicTokenType::CLS, Precedence::NONE},
+    {"COLOR", 5, BasicTokenType::COLOR, Precedence::NONE},
+    {"COS", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"CSNG", 4, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"CVI", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"CVS", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"DATA", 4, BasicTokenType::DATA, Precedence::NONE},
+    {"DEF", 3, BasicTokenType::DEF, Precedence::NONE},
+    {"DIM", 3, BasicTokenType::DIM, Precedence::NONE},
+    {"ELSE", 4, BasicTokenType::ELSE, Precedence::NONE},
+    {"END", 3, BasicTokenType::END, Precedence::NONE},
+    {"FIX", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"FOR", 3, BasicTokenType::FOR, Precedence::NONE},
+    {"GOSUB", 5, BasicTokenType::GOSUB, Precedence::NONE},
+    {"GOTO", 4, BasicTokenType::GOTO, Precedence::NONE},
+    {"IF", 2, BasicTokenType::IF, Precedence::NONE},
+    {"INKEY", 5, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"INPUT", 5, BasicTokenType::INPUT, Precedence::NONE},
+    {"INT", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"KEY", 3, BasicTokenType::KEY, Precedence::NONE},
+    {"LEN", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"LET", 3, BasicTokenType::LET, Precedence::NONE},
+    {"LINE", 4, BasicTokenType::LINE, Precedence::NONE},
+    {"LOCATE", 6, BasicTokenType::LOCATE, Precedence::NONE},
+    {"LOG", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"MAX", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"MIN", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"MKI", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"MKS", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"NEXT", 4, BasicTokenType::NEXT, Precedence::NONE},
+    {"NOT", 3, BasicTokenType::NOT, Precedence::NONE},
+    {"ON", 2, BasicTokenType::ON, Precedence::NONE},
+    {"OR", 2, BasicTokenType::OR, Precedence::OR},
+    {"PALETTE", 7, BasicTokenType::PALETTE, Precedence::NONE},
+    {"PCM", 3, BasicTokenType::PCM, Precedence::NONE},
+    {"PEEK", 4, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"PLAY", 4, BasicTokenType::PLAY, Precedence::NONE},
+    {"POKE", 4, BasicTokenType::POKE, Precedence::NONE},
+    {"PRINT", 5, BasicTokenType::PRINT, Precedence::NONE},
+    {"PSET", 4, BasicTokenType::PSET, Precedence::NONE},
+    {"PUT", 3, BasicTokenType::PUT, Precedence::NONE},
+    {"RANDOMIZE", 9, BasicTokenType::RANDOMIZE, Precedence::NONE},
+    {"READ", 4, BasicTokenType::READ, Precedence::NONE},
+    {"REM", 3, BasicTokenType::REM, Precedence::NONE},
+    {"RETURN", 6, BasicTokenType::RETURN, Precedence::NONE},
+    {"RND", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"SAMPLE", 6, BasicTokenType::SAMPLE, Precedence::NONE},
+    {"SGN", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"SIN", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"SOUND", 5, BasicTokenType::SOUND, Precedence::NONE},
+    {"SQR", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"STEP", 4, BasicTokenType::STEP, Precedence::NONE},
+    {"SWAP", 4, BasicTokenType::SWAP, Precedence::NONE},
+    {"TAN", 3, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"THEN", 4, BasicTokenType::THEN, Precedence::NONE},
+    {"TIMER", 5, BasicTokenType::TIMER, Precedence::NONE},
+    {"TO", 2, BasicTokenType::TO, Precedence::NONE},
+    {"VARPTR", 6, BasicTokenType::FUNCTION, Precedence::NONE},
+    {"VOICE", 5, BasicTokenType::VOICE, Precedence::NONE},
+    {"WAIT", 4, BasicTokenType::WAIT, Precedence::NONE},
+    {"WEND", 4, BasicTokenType::WEND, Precedence::NONE},
+    {"WHILE", 5, BasicTokenType::WHILE, Precedence::NONE},
+};
 
-        Environment(std::shared_ptr<Environment> parent) : parent(parent), offset(1) {
-        }
+static constexpr size_t KeywordCount = sizeof(Keywords) / sizeof(Keywords[0]);
 
-        const size_t Offset() const {
-            return offset;
-        }
+// Every keyword hashes to its own slot from its length and its first,
+// second and last letters, so a lookup is one hash and one compare.
+// The multipliers were picked by search, the static_assert below fails
+// the build if a new keyword collides, pick new ones when it does.
+static constexpr size_t KeywordSlots = 256;
 
-        const size_t size() const {
-            return vars.size();
-        }
+static constexpr size_t keywordHash(const char *word, size_t length) {
+    return (length * 7 + upper(word[0]) * 5 + upper(word[1]) * 18 + upper(word[length-1]) * 20) % KeywordSlots;
+}
 
-        uint32_t get(const std::string &name) const {
-            auto found = vars.find(name);
+struct KeywordTable {
+    // Index into Keywords plus one, 0 for an empty slot
+    uint8_t slots[KeywordSlots];
+    bool perfect;
+};
 
-            if (found != vars.end()) {
-                return found->second;
-            } else {
-                if (parent) {
-                    return parent->get(name);
-                } else {
-                    throw std::invalid_argument("Unknown variable `" + name + "'");
-                }
-            }
-        }
+static constexpr KeywordTable keywordTable() {
+    KeywordTable table = {{0}, true};
 
-        bool isGlobal(const std::string &name) {
-            auto found = vars.find(name);
+    for (size_t i = 0; i < KeywordCount; i++) {
+        auto slot = keywordHash(Keywords[i].name, Keywords[i].length);
 
-            if (found != vars.end() && parent) {
-                return false;
-            }
+        if (table.slots[slot])
+            table.perfect = false;
 
-            return true;
-        }
+        table.slots[slot] = i + 1;
+    }
 
-        uint32_t create(const std::string &name, size_t count=1) {
-            auto existing = vars.find(name);
-            if (existing != vars.end()) {
-                return existing->second;
-            }
+    return table;
+}
 
-            uint32_t next = Offset() + vars.size();
-            for (size_t i = 0; i  < count; i++) {
-                vars.insert(std::make_pair(name + std::string(i, ' '), next+i));
-            }
-            return next;
-        }
+static constexpr KeywordTable KeywordLookup = keywordTable();
+static_assert(KeywordLookup.perfect, "BASIC keyword hash has a collision");
+static_assert(KeywordCount < 256, "BASIC keyword table slots hold a uint8_t index");
 
-        std::shared_ptr<Environment> Parent() const {
-            return parent;
-        }
-};
+static const Keyword *findKeyword(std::string_view word) {
+    if (word.size() < 2)
+        return nullptr;
 
-std::vector<std::tuple<uint32_t, EventType, uint32_t>> events; 
+    auto slot = KeywordLookup.slots[keywordHash(word.data(), word.size())];
 
-static std::map<std::string, UserFunction> userfunctions;
+    if (!slot)
+        return nullptr;
 
-static int current = 0;
-static std::map<uint32_t, std::string> jumps;
-static std::stack<std::pair<uint32_t,uint32_t>> while_loops;
-static std::stack<std::tuple<uint32_t,uint32_t,std::string>> for_loops;
+    const auto &keyword = Keywords[slot-1];
 
-static std::shared_ptr<Environment> env;
+    if (keyword.length != word.size())
+        return nullptr;
 
-static bool isDigit(char c) {
-    return c >= '0' && c <= '9';
-}
+    for (size_t i = 0; i < word.size(); i++) {
+        if (upper(word[i]) != keyword.name[i])
+            return nullptr;
+    }
 
-static bool isAlpha(char c) {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    return &keyword;
 }
 
-static bool isWhitespace(char c) {
-    return (c == ' ') || (c == '\t');
-}
+static std::string str_toupper(std::string_view s) {
+    std::string res(s);
 
-static std::string str_toupper(std::string s) {
     std::transform(
-        s.begin(), s.end(), s.begin(),
+        res.begin(), res.end(), res.begin(),
         [](unsigned char c){ return std::toupper(c); }
     );
 
-    return s;
+    return res;
 }
 
-std::pair<uint32_t, std::vector<BasicToken>> parseLine(const std::string &line) {
+std::pair<uint32_t, std::vector<BasicToken>> parseLine(std::string_view line) {
     std::vector<BasicToken> tokens;
     size_t i = 0;
     uint32_t lineno = 0;
 
+    // The line is a view, often into a mapped file, so there is no
+    // terminator to stop on past its end
+    auto at = [&line](size_t pos) {
+        return pos < line.size() ? line[pos] : '\0';
+    };
+
     while (i < line.size()) {
         if (isDigit(line[i])) {
             lineno *= 10;
@@ -150,344 +231,57 @@ std::pair<uint32_t, std::vector<BasicToken>> parseLine(const std::string &line)
             auto tokenType = BasicTokenType::INT; 
             size_t start = i++;
 
-            while (isDigit(line[i]))
+            while (isDigit(at(i)))
                 i++;
 
-            if (line[i] == '.' && isDigit(line[i+1])) {
+            if (at(i) == '.' && isDigit(at(i+1))) {
                 tokenType = BasicTokenType::FLOAT;
                 i++;
 
-                while (isDigit(line[i]))
+                while (isDigit(at(i)))
                     i++;
             }
 
-            tokens.push_back(BasicToken(tokenType, line.substr(start, i-start)));
+            tokens.push_back(BasicToken(tokenType, std::string(line.substr(start, i-start))));
         } else if (isAlpha(line[i])) {
-            auto precedence = Precedence::NONE;
             size_t start = i++;
-            auto tokenType = BasicTokenType::IDENTIFIER;
 
-            while((isAlpha(line[i]) || isDigit(line[i])))
+            while((isAlpha(at(i)) || isDigit(at(i))))
                 i++;
 
-            auto token = line.substr(start, i-start);
-            auto keyword = str_toupper(token);
-
-            switch (keyword[0]) {
-                case 'A':
-                    if (keyword == "AND") {
-                        tokenType = BasicTokenType::AND;
-                        precedence = Precedence::AND;
-                    }
-                    else
-                    if (keyword == "ABS") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "ATAN") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    break;
-                case 'B':
-                    if (keyword == "BEEP") {
-                        tokenType = BasicTokenType::BEEP;
-                    }
-                case 'C':
-                    if (keyword == "CHR") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "CLS") {
-                        tokenType = BasicTokenType::CLS;
-                    }
-                    else
-                    if (keyword == "CINT") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "COLOR") {
-                        tokenType = BasicTokenType::COLOR;
-                    }
-                    else
-                    if (keyword == "COS") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "CSNG") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "CVI") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "CVS") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    break;
-                case 'D':
-                    if (keyword == "DATA") {
-                        tokenType = BasicTokenType::DATA;
-                    }
-                    else
-                    if (keyword == "DEF") {
-                        tokenType = BasicTokenType::DEF;
-                    }
-                    else
-                    if (keyword == "DIM") {
-                        tokenType = BasicTokenType::DIM;
-                    }
-                    break;
-                case 'E':
-                    if (keyword == "ELSE") {
-                        tokenType = BasicTokenType::ELSE;
-                    }
-                    else
-                    if (keyword == "END") {
-                        tokenType = BasicTokenType::END;
-                    }
-                    break;
-                case 'F':
-                    if (keyword == "FOR") {
-                        tokenType = BasicTokenType::FOR;
-                    }
-                    else
-                    if (keyword == "FIX") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword.substr(0,2) == "FN") {
-                        tokenType = BasicTokenType::USRFUNCTION;
-                    }
-                    break;
-                case 'G':
-                    if (keyword == "GOTO") {
-                        tokenType = BasicTokenType::GOTO;
-                    }
-                    else
-                    if (keyword == "GOSUB") {
-                        tokenType = BasicTokenType::GOSUB;
-                    }
-                    break;
-                case 'I':
-                    if (keyword == "IF") {
-                        tokenType = BasicTokenType::IF;
-                    }
-                    else
-                    if (keyword == "INKEY") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "INPUT") {
-                        tokenType = BasicTokenType::INPUT;
-                    }
-                    else
-                    if (keyword == "INT") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    break;
-                case 'K':
-                    if (keyword == "KEY") {
-                        tokenType = BasicTokenType::KEY;
-                    }
-                    break;
-                case 'L':
-                    if (keyword == "LEN") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "LET") {
-                        tokenType = BasicTokenType::LET;
-                    }
-                    else
-                    if (keyword == "LINE") {
-                        tokenType = BasicTokenType::LINE;
-                    }
-                    else
-                    if (keyword == "LOCATE") {
-                        tokenType = BasicTokenType::LOCATE;
-                    }
-                    else
-                    if (keyword == "LOG") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    break;
-                case 'M':
-                    if (keyword == "MAX") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "MIN") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "MKI") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "MKS") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    break;
-                case 'N':
-                    if (keyword == "NEXT") {
-                        tokenType = BasicTokenType::NEXT;
-                    }
-                    else
-                    if (keyword == "NOT") {
-                        tokenType = BasicTokenType::NOT;
-                    }
-                    break;
-                case 'O':
-                    if (keyword == "ON") {
-                        tokenType = BasicTokenType::ON;
-                    }
-                    else
-                    if (keyword == "OR") {
-                        precedence = Precedence::OR;
-                        tokenType = BasicTokenType::OR;
-                    }
-                    break;
-                case 'P':
-                    if (keyword == "PALETTE") {
-                        tokenType = BasicTokenType::PALETTE;
-                    }
-                    else
-                    if (keyword == "PEEK") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "POKE") {
-                        tokenType = BasicTokenType::POKE;
-                    }
-                    else
-                    if (keyword == "PRINT") {
-                        tokenType = BasicTokenType::PRINT;
-                    }
-                    else
-                    if (keyword == "PSET") {
-                        tokenType = BasicTokenType::PSET;
-                    }
-                    else
-                    if (keyword == "PUT") {
-                        tokenType = BasicTokenType::PUT;
-                    }
-                    break;
-                case 'R':
-                    if (keyword == "RANDOMIZE") {
-                        tokenType = BasicTokenType::RANDOMIZE;
-                    }
-                    else
-                    if (keyword == "READ") {
-                        tokenType = BasicTokenType::READ;
-                    }
-                    else
-                    if (keyword == "REM") {
-                        tokenType = BasicTokenType::REM;
-                    }
-                    else
-                    if (keyword == "RETURN") {
-                        tokenType = BasicTokenType::RETURN;
-                    }
-                    else
-                    if (keyword == "RND") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    break;
-                case 'S':
-                    if (keyword == "SGN") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "SIN") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "SQR") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "SOUND") {
-                        tokenType = BasicTokenType::SOUND;
-                    }
-                    else
-                    if (keyword == "STEP") {
-                        tokenType = BasicTokenType::STEP;
-                    }
-                    else
-                    if (keyword == "SWAP") {
-                        tokenType = BasicTokenType::SWAP;
-                    }
-                    break;
-                case 'T':
-                    if (keyword == "TAN") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "THEN") {
-                        tokenType = BasicTokenType::THEN;
-                    }
-                    else
-                    if (keyword == "TIMER") {
-                        tokenType = BasicTokenType::TIMER;
-                    }
-                    else
-                    if (keyword == "TO") {
-                        tokenType = BasicTokenType::TO;
-                    }
-                    break;
-                case 'V':
-                    if (keyword == "VARPTR") {
-                        tokenType = BasicTokenType::FUNCTION;
-                    }
-                    else
-                    if (keyword == "VOICE") {
-                        tokenType = BasicTokenType::VOICE;
-                    }
-                    break;
-                case 'W':
-                    if (keyword == "WAIT") {
-                        tokenType = BasicTokenType::WAIT;
-                    }
-                    else
-                    if (keyword == "WHILE") {
-                        tokenType = BasicTokenType::WHILE;
-                    }
-                    else
-                    if (keyword == "WEND") {
-                        tokenType = BasicTokenType::WEND;
-                    }
-                    break;
-                default:
-                    break;
-            }
-
-            if (tokenType != BasicTokenType::IDENTIFIER)
-                token = keyword;
+            auto word = line.substr(start, i-start);
+            auto keyword = findKeyword(word);
 
-            tokens.push_back(BasicToken(tokenType, token, precedence));
+            if (keyword) {
+                tokens.push_back(BasicToken(keyword->type, keyword->name, keyword->precedence));
+            } else if (word.size() >= 2 && upper(word[0]) == 'F' && upper(word[1]) == 'N') {
+                tokens.push_back(BasicToken(BasicTokenType::USRFUNCTION, str_toupper(word)));
+            } else {
+                tokens.push_back(BasicToken(BasicTokenType::IDENTIFIER, std::string(word)));
+            }
         } else if (line[i] == '"') {
             i++;
             std::string str;
-            while (line[i++] != '"') {
-                char c = line[i-1];
+            while (i < line.size() && line[i] != '"') {
+                char c = line[i++];
 
-                if (c == '\\' && line[i] == 'n') {
+                if (c == '\\' && at(i) == 'n') {
                     c = '\n';
                     i++;
-                } else if (c == '\\' && line[i] == '"') {
+                } else if (c == '\\' && at(i) == '"') {
                     c = '"';
                     i++;
-                } else if (c == '\\' && line[i] == 't') {
+                } else if (c == '\\' && at(i) == 't') {
                     c = '\t';
                     i++;
-                } else if (c == '\\' && line[i] == '\\') {
+                } else if (c == '\\' && at(i) == '\\') {
                     c = '\\';
                     i++;
                 }
 
                 str += c;
             }
+            i++;
 
             tokens.push_back(BasicToken(BasicTokenType::STRING, str));
         } else {
@@ -529,7 +323,7 @@ std::pair<uint32_t, std::vector<BasicToken>> parseLine(const std::string &line)
                     tokens.push_back(BasicToken(BasicTokenType::EQUAL, "=", Precedence::EQUALITY));
                     break;
                 case '>':
-                        switch (line[i]) {
+                        switch (at(i)) {
                             case '=':
                                 tokens.push_back(BasicToken(BasicTokenType::GREATER_EQUAL, ">=", Precedence::COMPARISON));
                                 i++;
@@ -539,7 +333,7 @@ std::pair<uint32_t, std::vector<BasicToken>> parseLine(const std::string &line)
                         }
                     break;
                 case '<':
-                        switch (line[i]) {
+                        switch (at(i)) {
                             case '>':
                                 tokens.push_back(BasicToken(BasicTokenType::NOT_EQUAL, "<>", Precedence::EQUALITY));
                                 i++;
@@ -567,32 +361,150 @@ std::pair<uint32_t, std::vector<BasicToken>> parseLine(const std::string &line)
     return std::pair<uint32_t, std::vector<BasicToken>>(lineno, tokens);
 }
 
+// The whole of a source file, mapped read only where the platform has
+// mmap and read into memory where it hasn't, or the file can't be mapped
+class SourceFile {
+        const char *data;
+        size_t size;
+        std::string buffer;
+#ifdef MAP_SOURCE
+        void *mapped;
+#endif
+    public:
+        SourceFile(const std::string &filename) : data(NULL), size(0) {
+#ifdef MAP_SOURCE
+            mapped = MAP_FAILED;
+
+            int fd = open(filename.c_str(), O_RDONLY);
+
+            if (fd < 0) {
+                std::cerr << "Could not open `" << filename << "'" << std::endl;
+                exit(-1);
+            }
+
+            struct stat st;
+
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (mapped != MAP_FAILED) {
+                    data = (const char *)mapped;
+                    size = st.st_size;
+                }
+            }
+
+            close(fd);
+
+            if (data)
+                return;
+#endif
+            std::ifstream infile(filename, std::ios::binary);
+
+            if (!infile.is_open()) {
+                std::cerr << "Could not open `" << filename << "'" << std::endl;
+                exit(-1);
+            }
+
+            std::ostringstream contents;
+            contents << infile.rdbuf();
+            buffer = contents.str();
+
+            data = buffer.data();
+            size = buffer.size();
+        }
+
+        ~SourceFile() {
+#ifdef MAP_SOURCE
+            if (mapped != MAP_FAILED)
+                munmap(mapped, size);
+#endif
+        }
+
+        SourceFile(const SourceFile &) = delete;
+        SourceFile &operator=(const SourceFile &) = delete;
+
+        std::string_view View() const {
+            return std::string_view(data, size);
+        }
+};
+
+// Below this many lines per thread tokenising is quicker than starting one
+#define LINES_PER_WORKER 2048
+
 std::map<uint32_t, std::vector<BasicToken>> parseFile(const std::string &filename) {
     std::map<uint32_t, std::vector<BasicToken>> tokens;
-    std::string line;
-    std::ifstream infile(filename);
+    SourceFile source(filename);
+    auto text = source.View();
+
+    // Split the same way std::getline does, a final newline does not
+    // start another line
+    std::vector<std::string_view> lines;
+    size_t start = 0;
+
+    while (start < text.size()) {
+        auto end = text.find('\n', start);
 
-    if (!infile.is_open()) {
-        std::cerr << "Could not open `" << filename << "'" << std::endl;
-        exit(-1);
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
     }
 
-    while (std::getline(infile, line)) {
-        auto data = parseLine(line); 
+    std::vector<std::pair<uint32_t, std::vector<BasicToken>>> parsed(lines.size());
+
+    auto tokenise = [&lines, &parsed](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            parsed[i] = parseLine(lines[i]);
+    };
+
+#ifndef __EMSCRIPTEN__
+    size_t workers = std::min<size_t>(std::thread::hardware_concurrency(), lines.size() / LINES_PER_WORKER);
+
+    if (workers > 1) {
+        std::vector<std::thread> threads;
 
-        tokens[data.first] = data.second;
+        for (size_t w = 0; w < workers; w++)
+            threads.push_back(std::thread(tokenise, lines.size() * w / workers, lines.size() * (w + 1) / workers));
+
+        for (auto &thread : threads)
+            thread.join();
+    } else {
+        tokenise(0, lines.size());
+    }
+#else
+    // No pthreads in the browser build
+    tokenise(0, lines.size());
+#endif
+
+    // In file order, so a repeated line number keeps its last definition
+    for (auto &data : parsed) {
+        tokens[data.first] = std::move(data.second);
     }
 
     return tokens;
 }
 
-static void error(uint32_t linenumber, const std::string &err) {
+Compiler::Compiler() : current(0) {
+}
+
+void Compiler::reset() {
+    current = 0;
+    jumps.clear();
+    while_loops = {};
+    for_loops = {};
+    userfunctions.clear();
+    events.clear();
+    env.reset();
+}
+
+void Compiler::error(uint32_t linenumber, const std::string &err) {
     std::ostringstream s;
     s << "Error on line " << linenumber << " at position " << current << ": " << err;
     throw std::domain_error(s.str());
 }
 
-static std::string identifier(uint32_t linenumber, const BasicToken &token) {
+std::string Compiler::identifier(uint32_t linenumber, const BasicToken &token) {
     if (token.type != BasicTokenType::IDENTIFIER) {
         error(linenumber, "Identifier expected");
     }
@@ -600,22 +512,20 @@ static std::string identifier(uint32_t linenumber, const BasicToken &token) {
     return token.str;
 }
 
-static void check(uint32_t linenumber, const BasicToken &token, BasicTokenType type, const std::string &err) {
+void Compiler::check(uint32_t linenumber, const BasicToken &token, BasicTokenType type, const std::string &err) {
     if (token.type != type)
         error(linenumber, err);
 }
 
-static void expression(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp=0);
-
-static void function(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
-    auto token = tokens[current];
+void Compiler::function(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+    const auto &token = tokens[current];
 
     check(linenumber, tokens[current+1], BasicTokenType::LEFT_PAREN, "`(' expected");
 
     current += 2;
 
     if (token.str == "ABS") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPA);
         program.addValue(OpCode::SETB, ShortAsValue(0));
@@ -624,38 +534,38 @@ static void function(Program &program, uint32_t linenumber, const std::vector<Ba
         program.add(OpCode::MUL);
         program.add(OpCode::PUSHC);
     } else if (token.str == "ATAN") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::ATAN);
         program.add(OpCode::PUSHC);
     } else if (token.str == "CHR") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.addShort(OpCode::ALLOC, 2);
         program.add(OpCode::POPC);
         program.add(OpCode::WRITECX);
         program.add(OpCode::PUSHIDX);
     } else if (token.str == "CINT" || token.str == "INT") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::INT);
         program.add(OpCode::PUSHC);
     } else if (token.str == "COS") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::COS);
         program.add(OpCode::PUSHC);
     } else if (token.str == "CSNG") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::FLT);
         program.add(OpCode::PUSHC);
     } else if (token.str == "CVI" || token.str == "CVS") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPIDX);
         program.add(OpCode::VSTR);
@@ -664,14 +574,14 @@ static void function(Program &program, uint32_t linenumber, const std::vector<Ba
         if (tokens[current].type == BasicTokenType::RIGHT_PAREN) {
             program.addSyscall(OpCode::SYSCALL, SysCall::READKEY, RuntimeValue::C);
         } else {
-            expression(program, linenumber, {tokens.begin(), tokens.end()});
+            expression(program, linenumber, tokens);
             check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
             program.addSyscall(OpCode::SYSCALL, SysCall::KEYSET, RuntimeValue::C);
         }
 
         program.add(OpCode::PUSHC);
     } else if (token.str == "LEN") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPIDX);
         program.addValue(OpCode::SETB, ShortAsValue(0));
@@ -691,15 +601,15 @@ static void function(Program &program, uint32_t linenumber, const std::vector<Ba
         program.add(OpCode::PUSHC);
         program.updateShort(cmp+1, end);
     } else if (token.str == "LOG") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::LOG);
         program.add(OpCode::PUSHC);
     } else if (token.str == "MAX") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
@@ -710,9 +620,9 @@ static void function(Program &program, uint32_t linenumber, const std::vector<Ba
         auto end = program.add(OpCode::PUSHA);
         program.updateShort(cmp+1, end);
     } else if (token.str == "MIN") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
@@ -724,45 +634,51 @@ static void function(Program &program, uint32_t linenumber, const std::vector<Ba
         program.updateShort(cmp+1, end);
 
     } else if (token.str == "MKI" || token.str == "MKS") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPIDX);
         program.add(OpCode::VSTR);
         program.add(OpCode::PUSHC);
     } else if (token.str == "PEEK") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::MOVCIDX);
         program.add(OpCode::IDXC);
         program.add(OpCode::PUSHC);
+    } else if (token.str == "PLAY") {
+        expression(program, linenumber, tokens);
+        check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
+        program.add(OpCode::POPC);
+        program.addSyscall(OpCode::SYSCALL, SysCall::PLAYING, RuntimeValue::C);
+        program.add(OpCode::PUSHC);
     } else if (token.str == "RND") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::RND);
         program.add(OpCode::PUSHC);
     } else if (token.str == "SGN") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPA);
         program.addValue(OpCode::SETB, ShortAsValue(0));
         program.add(OpCode::CMP);
         program.add(OpCode::PUSHC);
     } else if (token.str == "SIN") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::SIN);
         program.add(OpCode::PUSHC);
     } else if (token.str == "SQR") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::SQR);
         program.add(OpCode::PUSHC);
     } else if (token.str == "TAN") {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
         program.add(OpCode::POPC);
         program.add(OpCode::TAN);
@@ -777,8 +693,8 @@ static void function(Program &program, uint32_t linenumber, const std::vector<Ba
     }
 }
 
-static void usrfunction(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
-    auto token = tokens[current];
+void Compiler::usrfunction(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+    const auto &token = tokens[current];
 
     check(linenumber, tokens[current+1], BasicTokenType::LEFT_PAREN, "`(' expected");
 
@@ -794,13 +710,13 @@ static void usrfunction(Program &program, uint32_t linenumber, const std::vector
     size_t argcount = 0;
 
     if (tokens[current].type != BasicTokenType::RIGHT_PAREN) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         argcount++;
     }
 
     while (tokens[current].type != BasicTokenType::RIGHT_PAREN) {
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         argcount++;
     }
     check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
@@ -813,8 +729,8 @@ static void usrfunction(Program &program, uint32_t linenumber, const std::vector
 }
 
 
-static void TokenAsValue(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
-    auto token = tokens[current];
+void Compiler::TokenAsValue(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+    const auto &token = tokens[current];
 
     if (token.type == BasicTokenType::STRING) {
         program.addShort(OpCode::ALLOC, token.str.size()+1);
@@ -843,7 +759,7 @@ static void TokenAsValue(Program &program, uint32_t linenumber, const std::vecto
             program.add(OpCode::POPIDX);
             program.add(OpCode::PUSHC);
         }
-    } else if (token.type == BasicTokenType::FUNCTION) {
+    } else if (token.type == BasicTokenType::FUNCTION || token.type == BasicTokenType::PLAY) {
         function(program, linenumber, tokens);
     } else if (token.type == BasicTokenType::USRFUNCTION) {
         usrfunction(program, linenumber, tokens);
@@ -852,95 +768,95 @@ static void TokenAsValue(Program &program, uint32_t linenumber, const std::vecto
     }
 }
 
-static void Op(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
-    auto token = tokens[current++];
+void Compiler::Op(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+    const auto &token = tokens[current++];
 
     if (token.type == BasicTokenType::STAR) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::MUL);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::SLASH) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::DIV);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::PLUS) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::ADD);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::MINUS) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::SUB);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::PERCENT) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::MOD);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::BACKSLASH) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::IDIV);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::CARAT) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::POW);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::EQUAL) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::EQ);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::NOT_EQUAL) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::NE);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::LESS) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::LT);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::GREATER) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::GT);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::LESS_EQUAL) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::LE);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::GREATER_EQUAL) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::GE);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::AND) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::AND);
         program.add(OpCode::PUSHC);
     } else if (token.type == BasicTokenType::OR) {
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, token.lbp);
+        expression(program, linenumber, tokens, token.lbp);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.add(OpCode::OR);
@@ -948,12 +864,12 @@ static void Op(Program &program, uint32_t linenumber, const std::vector<BasicTok
     } else if (token.type == BasicTokenType::LEFT_PAREN) {
         program.add(OpCode::POPIDX);
 
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         while (tokens[current].type != BasicTokenType::RIGHT_PAREN) {
             check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
 
-            expression(program, linenumber, {tokens.begin(), tokens.end()});
+            expression(program, linenumber, tokens);
 
             program.add(OpCode::IDXA);
             program.add(OpCode::POPB);
@@ -987,10 +903,10 @@ static void Op(Program &program, uint32_t linenumber, const std::vector<BasicTok
     }
 }
 
-static void prefix(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp) {
+void Compiler::prefix(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp) {
     if (tokens[current].type == BasicTokenType::LEFT_PAREN) {
         current++;
-        expression(program, linenumber, {tokens.begin(), tokens.end()}, 0);
+        expression(program, linenumber, tokens, 0);
         check(linenumber, tokens[current], BasicTokenType::RIGHT_PAREN, "`)' expected");
     } else if (tokens[current].type == BasicTokenType::NOT) {
         current++;
@@ -1013,23 +929,20 @@ static void prefix(Program &program, uint32_t linenumber, const std::vector<Basi
     }
 }
 
-static void expression(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp) {
+void Compiler::expression(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp) {
     if (tokens.size() == 0) {
         error(linenumber, "Expression expected");
     }
 
     prefix(program, linenumber, tokens, rbp);
-    auto token = tokens[++current];
+    current++;
 
-    while (rbp < token.lbp) {
-        Op(program, linenumber, {tokens.begin(), tokens.end()});
-        token = tokens[current];
+    while (rbp < tokens[current].lbp) {
+        Op(program, linenumber, tokens);
     }
 }
 
-static void statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
-
-static void if_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::if_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     expression(program, linenumber, tokens);
     program.add(OpCode::POPC); 
     check(linenumber, tokens[current++], BasicTokenType::THEN, "`THEN' expected");
@@ -1052,7 +965,7 @@ static void if_statement(Program &program, uint32_t linenumber, const std::vecto
     }
 }
 
-static void while_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::while_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     auto loop = program.add(OpCode::NOP);
     expression(program, linenumber, tokens);
     program.add(OpCode::POPC); 
@@ -1061,7 +974,7 @@ static void while_statement(Program &program, uint32_t linenumber, const std::ve
     while_loops.push(std::pair<uint32_t,uint32_t>(loop, _false));
 }
 
-static void wend_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::wend_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     if (while_loops.size() == 0)
         error(linenumber, "WEND without WHILE");
 
@@ -1073,7 +986,7 @@ static void wend_statement(Program &program, uint32_t linenumber, const std::vec
     program.updateShort(loop.second+1, pos);
 }
 
-static void for_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::for_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     auto name = identifier(linenumber, tokens[current++]);
     check(linenumber, tokens[current++], BasicTokenType::EQUAL, "`=' expected");
     expression(program, linenumber, tokens);
@@ -1103,7 +1016,7 @@ static void for_statement(Program &program, uint32_t linenumber, const std::vect
     for_loops.push(std::tuple<uint32_t,uint32_t,std::string>(cmp, _false, name));
 }
 
-static void next_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::next_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     if (for_loops.size() == 0)
         error(linenumber, "NEXT without FOR");
 
@@ -1123,10 +1036,10 @@ static void next_statement(Program &program, uint32_t linenumber, const std::vec
     program.updateShort(std::get<1>(loop)+1, pos);
 }
 
-static void statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     if (tokens[current].type == BasicTokenType::PRINT) {
         current++;
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.addSyscall(OpCode::SYSCALL, SysCall::WRITE, RuntimeValue::C);
     } else if (tokens[current].type == BasicTokenType::INPUT) {
@@ -1161,12 +1074,12 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
             current += 3;
             program.addPointer(OpCode::LOADIDX, env->get(name));
 
-            expression(program, linenumber, {tokens.begin(), tokens.end()});
+            expression(program, linenumber, tokens);
 
             while (tokens[current].type != BasicTokenType::RIGHT_PAREN) {
                 check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
 
-                expression(program, linenumber, {tokens.begin(), tokens.end()});
+                expression(program, linenumber, tokens);
 
                 program.add(OpCode::IDXA);
                 program.add(OpCode::POPB);
@@ -1241,9 +1154,9 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         current += 2;
     } else if (tokens[current].type == BasicTokenType::POKE) {
         current += 1;
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         program.add(OpCode::POPA);
         program.add(OpCode::POPC);
@@ -1257,22 +1170,22 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         current += 1;
     } else if (tokens[current].type == BasicTokenType::PALETTE) {
         current += 1;
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.addSyscall(OpCode::SYSCALL, SysCall::PALETTE, RuntimeValue::C);
     } else if (tokens[current].type == BasicTokenType::COLOR) {
         current += 1;
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.addSyscall(OpCode::SYSCALL, SysCall::COLOUR, RuntimeValue::NONE);
     } else if (tokens[current].type == BasicTokenType::LOCATE) {
         current += 1;
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPB);
         program.add(OpCode::POPA);
         program.addSyscall(OpCode::SYSCALL, SysCall::CURSOR, RuntimeValue::NONE);
@@ -1284,9 +1197,9 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         program.addSyscall(OpCode::SYSCALL, SysCall::SOUND, RuntimeValue::NONE);
     } else if (tokens[current].type == BasicTokenType::VOICE) {
         current += 1;
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         if (tokens[current].type == BasicTokenType::COMMA) {
             auto voiceptr = env->get(VOICE_INDEX);
@@ -1296,10 +1209,20 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
 
             for (size_t i = 1; i < VOICE_ARGS; i++) {
                 check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-                expression(program, linenumber, {tokens.begin(), tokens.end()});
+                expression(program, linenumber, tokens);
                 program.add(OpCode::POPC);
                 program.addPointer(OpCode::STOREC, voiceptr+i);
             }
+
+            // Optional pan, 0 left to 255 right
+            if (tokens[current].type == BasicTokenType::COMMA) {
+                current++;
+                expression(program, linenumber, tokens);
+                program.add(OpCode::POPB);
+            } else {
+                program.addValue(OpCode::SETB, ShortAsValue(128));
+            }
+
             program.addPointer(OpCode::SETIDX, voiceptr);
             program.add(OpCode::POPC);
         } else {
@@ -1307,19 +1230,20 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
             program.add(OpCode::PUSHC);
             program.add(OpCode::POPIDX);
             program.add(OpCode::POPC);
+            program.addValue(OpCode::SETB, ShortAsValue(128));
         }
 
         program.addSyscall(OpCode::SYSCALL, SysCall::VOICE, RuntimeValue::C);
     } else if (tokens[current].type == BasicTokenType::SOUND) {
         current += 1;
 
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         if (tokens[current].type == BasicTokenType::COMMA) {
             current++;
-            expression(program, linenumber, {tokens.begin(), tokens.end()});
+            expression(program, linenumber, tokens);
             program.add(OpCode::POPC);
         } else {
             program.addValue(OpCode::SETC, ShortAsValue(0));
@@ -1329,14 +1253,92 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         program.add(OpCode::POPA);
 
         program.addSyscall(OpCode::SYSCALL, SysCall::SOUND, RuntimeValue::NONE);
+    } else if (tokens[current].type == BasicTokenType::PLAY) {
+        current += 1;
+
+        expression(program, linenumber, tokens);
+
+        if (tokens[current].type == BasicTokenType::COMMA) {
+            current++;
+            expression(program, linenumber, tokens);
+            program.add(OpCode::POPC);
+        } else {
+            program.addValue(OpCode::SETC, ShortAsValue(0));
+        }
+
+        program.add(OpCode::POPIDX);
+
+        program.addSyscall(OpCode::SYSCALL, SysCall::PLAY, RuntimeValue::IDX);
+    } else if (tokens[current].type == BasicTokenType::SAMPLE) {
+        current += 1;
+
+        auto sampleptr = env->get(SAMPLE_INDEX);
+
+        // Sample id and the array holding it
+        expression(program, linenumber, tokens);
+        program.add(OpCode::POPC);
+        program.addPointer(OpCode::STOREC, sampleptr);
+
+        check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
+        expression(program, linenumber, tokens);
+        program.add(OpCode::POPC);
+        program.addPointer(OpCode::STOREC, sampleptr+1);
+
+        // Optional bits, 8 or 16, then optional loop start and end
+        if (tokens[current].type == BasicTokenType::COMMA) {
+            current++;
+            expression(program, linenumber, tokens);
+            program.add(OpCode::POPC);
+        } else {
+            program.addValue(OpCode::SETC, ShortAsValue(8));
+        }
+        program.addPointer(OpCode::STOREC, sampleptr+2);
+
+        if (tokens[current].type == BasicTokenType::COMMA) {
+            current++;
+            expression(program, linenumber, tokens);
+            program.add(OpCode::POPC);
+            program.addPointer(OpCode::STOREC, sampleptr+3);
+
+            check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
+            expression(program, linenumber, tokens);
+            program.add(OpCode::POPC);
+            program.addPointer(OpCode::STOREC, sampleptr+4);
+        } else {
+            program.addValue(OpCode::SETC, ShortAsValue(0));
+            program.addPointer(OpCode::STOREC, sampleptr+3);
+            program.addPointer(OpCode::STOREC, sampleptr+4);
+        }
+
+        program.addPointer(OpCode::SETIDX, sampleptr);
+        program.addSyscall(OpCode::SYSCALL, SysCall::SAMPLE, RuntimeValue::IDX);
+    } else if (tokens[current].type == BasicTokenType::PCM) {
+        current += 1;
+
+        expression(program, linenumber, tokens);
+        check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
+        expression(program, linenumber, tokens);
+
+        if (tokens[current].type == BasicTokenType::COMMA) {
+            current++;
+            expression(program, linenumber, tokens);
+            program.add(OpCode::POPC);
+        } else {
+            program.addValue(OpCode::SETC, ShortAsValue(0));
+        }
+
+        program.add(OpCode::POPB);
+        program.add(OpCode::POPA);
+
+        program.addSyscall(OpCode::SYSCALL, SysCall::PCM, RuntimeValue::NONE);
     } else if (tokens[current].type == BasicTokenType::SWAP) {
         current += 1;
 
         auto left = identifier(linenumber, tokens[current]);
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
         auto right = identifier(linenumber, tokens[current]);
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         program.add(OpCode::POPC);
         program.addPointer(OpCode::STOREC, env->get(left));
@@ -1351,7 +1353,7 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         if (tokens[current].type == BasicTokenType::TIMER) {
             program.addValue(OpCode::SETC, ShortAsValue((int16_t)time(NULL)));
         } else {
-            expression(program, linenumber, {tokens.begin(), tokens.end()});
+            expression(program, linenumber, tokens);
         }
         program.add(OpCode::SEED);
     } else if (tokens[current].type == BasicTokenType::END) {
@@ -1360,29 +1362,29 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         current += 1;
     } else if (tokens[current].type == BasicTokenType::IF) {
         current++;
-        if_statement(program, linenumber, {tokens.begin(), tokens.end()});
+        if_statement(program, linenumber, tokens);
     } else if (tokens[current].type == BasicTokenType::WHILE) {
         current++;
-        while_statement(program, linenumber, {tokens.begin(), tokens.end()});
+        while_statement(program, linenumber, tokens);
     } else if (tokens[current].type == BasicTokenType::WEND) {
         current++;
-        wend_statement(program, linenumber, {tokens.begin(), tokens.end()});
+        wend_statement(program, linenumber, tokens);
     } else if (tokens[current].type == BasicTokenType::FOR) {
         current++;
-        for_statement(program, linenumber, {tokens.begin(), tokens.end()});
+        for_statement(program, linenumber, tokens);
     } else if (tokens[current].type == BasicTokenType::NEXT) {
         current++;
-        next_statement(program, linenumber, {tokens.begin(), tokens.end()});
+        next_statement(program, linenumber, tokens);
     } else if (tokens[current].type == BasicTokenType::PSET) {
         current++;
 
         check(linenumber, tokens[current++], BasicTokenType::LEFT_PAREN, "`(' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::RIGHT_PAREN, "`)' expected");
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         program.add(OpCode::POPC);
         program.add(OpCode::POPB);
@@ -1392,9 +1394,9 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         current++;
 
         check(linenumber, tokens[current++], BasicTokenType::LEFT_PAREN, "`(' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::RIGHT_PAREN, "`)' expected");
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
         auto dst = identifier(linenumber, tokens[current++]);
@@ -1413,7 +1415,7 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         check(linenumber, tokens[current++], BasicTokenType::KEY, "`KEY' expected");
 
         check(linenumber, tokens[current++], BasicTokenType::LEFT_PAREN, "`(' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         check(linenumber, tokens[current++], BasicTokenType::RIGHT_PAREN, "`)' expected");
         check(linenumber, tokens[current++], BasicTokenType::GOSUB, "`GOSUB' expected");
 
@@ -1430,13 +1432,13 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         program.addPointer(OpCode::SETIDX, env->get(LINE_INDEX));
 
         check(linenumber, tokens[current++], BasicTokenType::LEFT_PAREN, "`(' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.add(OpCode::WRITECX);
         program.addValue(OpCode::INCIDX, ShortAsValue(1));
 
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.add(OpCode::WRITECX);
         program.addValue(OpCode::INCIDX, ShortAsValue(1));
@@ -1446,20 +1448,20 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         check(linenumber, tokens[current++], BasicTokenType::MINUS, "`-' expected");
 
         check(linenumber, tokens[current++], BasicTokenType::LEFT_PAREN, "`(' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.add(OpCode::WRITECX);
         program.addValue(OpCode::INCIDX, ShortAsValue(1));
 
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.add(OpCode::WRITECX);
         program.addValue(OpCode::INCIDX, ShortAsValue(1));
 
         check(linenumber, tokens[current++], BasicTokenType::RIGHT_PAREN, "`)' expected");
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         program.add(OpCode::POPC);
         program.add(OpCode::WRITECX);
         program.addValue(OpCode::INCIDX, ShortAsValue(1));
@@ -1489,7 +1491,7 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         auto name = identifier(linenumber, tokens[current++]);
 
         check(linenumber, tokens[current++], BasicTokenType::EQUAL, "`=' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         program.add(OpCode::POPC);
         program.addPointer(OpCode::STOREC, env->create(name));
@@ -1538,7 +1540,7 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
 
         program.addPointer(OpCode::SAVEIDX, env->get(FRAME_INDEX));
 
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         userfunctions.insert(std::make_pair(func.str, UserFunction(call, args)));
         env = env->Parent();
@@ -1563,12 +1565,12 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
 
         program.addPointer(OpCode::LOADIDX, env->get(name));
 
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         while (tokens[current].type != BasicTokenType::RIGHT_PAREN) {
             check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
 
-            expression(program, linenumber, {tokens.begin(), tokens.end()});
+            expression(program, linenumber, tokens);
 
             program.add(OpCode::IDXA);
             program.add(OpCode::POPB);
@@ -1597,7 +1599,7 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
         program.add(OpCode::PUSHIDX);
         check(linenumber, tokens[current++], BasicTokenType::EQUAL, "`=' expected");
 
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
 
         program.add(OpCode::POPC);
 
@@ -1614,28 +1616,28 @@ static void statement(Program &program, uint32_t linenumber, const std::vector<B
     }
 }
 
-static void declaration(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::declaration(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     auto name = identifier(linenumber, tokens[current++]);
 
     check(linenumber, tokens[current++], BasicTokenType::EQUAL, "`=' expected");
-    expression(program, linenumber, {tokens.begin(), tokens.end()});
+    expression(program, linenumber, tokens);
 
     program.add(OpCode::POPC); 
     program.addPointer(OpCode::STOREC, env->create(name));
 }
 
-static void dim_declaration(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
+void Compiler::dim_declaration(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens) {
     auto name = identifier(linenumber, tokens[current++]);
     std::stack<int16_t> data_lengths;
 
     check(linenumber, tokens[current++], BasicTokenType::LEFT_PAREN, "`(' expected");
-    expression(program, linenumber, {tokens.begin(), tokens.end()});
+    expression(program, linenumber, tokens);
 
     int size = 1;
 
     while (tokens[current].type != BasicTokenType::RIGHT_PAREN) {
         check(linenumber, tokens[current++], BasicTokenType::COMMA, "`,' expected");
-        expression(program, linenumber, {tokens.begin(), tokens.end()});
+        expression(program, linenumber, tokens);
         size++;
     }
     check(linenumber, tokens[current++], BasicTokenType::RIGHT_PAREN, "`)' expected");
@@ -1675,7 +1677,9 @@ static void dim_declaration(Program &program, uint32_t linenumber, const std::ve
     }
 }
 
-void compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &program) {
+void Compiler::compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &program) {
+    reset();
+
     uint32_t entry = program.add(OpCode::NOP);
 
     program.setEntryPoint(entry);
@@ -1689,13 +1693,13 @@ void compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &
     );
 
     int datacount = 0;
-    for (auto dataline : datalines) {
+    for (const auto &dataline : datalines) {
         uint32_t linenumber = dataline.first;
         const std::vector<BasicToken> &tokens = dataline.second;
 
         bool comma_expected = false;
 
-        for (auto token : tokens) {
+        for (const auto &token : tokens) {
             if (token.type == BasicTokenType::DATA)
                 continue;
 
@@ -1734,11 +1738,12 @@ void compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &
     env->create(VOICE_INDEX, VOICE_ARGS);
     env->create(FRAME_INDEX);
     env->create(LINE_INDEX, LINE_ARGS);
+    env->create(SAMPLE_INDEX, SAMPLE_ARGS);
 
     auto frame = program.addValue(OpCode::SETC, PointerAsValue(0));
     program.addPointer(OpCode::STOREC, env->create(FRAME_INDEX));
 
-    for (auto line : lines) {
+    for (const auto &line : lines) {
         current = 0;
         uint32_t linenumber = line.first;
         const std::vector<BasicToken> &tokens = line.second;
@@ -1765,3 +1770,9 @@ void compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &
 
     program.updateValue(frame+1, PointerAsValue(env->Offset() + env->size()));
 }
+
+void compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &program) {
+    Compiler compiler;
+
+    compiler.compile(lines, program);
+}
@@ -2,10 +2,15 @@
 #define __EMULATOR_BASIC_H__
 
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <vector>
 #include <map>
 #include <iostream>
+#include <memory>
+#include <stack>
+#include <tuple>
+#include <stdexcept>
 
 #include "Emulator/VM.h"
 
@@ -80,6 +85,8 @@ namespace Emulator {
         NEXT,
         ON,
         PALETTE,
+        PCM,
+        PLAY,
         POKE,
         PRINT,
         PSET,
@@ -88,6 +95,7 @@ namespace Emulator {
         READ,
         REM,
         RETURN,
+        SAMPLE,
         SOUND,
         STEP,
         SWAP,
@@ -149,9 +157,122 @@ namespace Emulator {
             return str;
         }
     };
+
+    struct UserFunction {
+        uint32_t call;
+        std::vector<std::string> args;
+
+        UserFunction(uint32_t call, std::vector<std::string> args) {
+            this->call = call;
+            this->args = args;
+        }
+    };
+
+    class Environment {
+        private:
+            std::map<const std::string, uint32_t> vars;
+            std::shared_ptr<Environment> parent;
+            const uint32_t offset;
+        public:
+            Environment(uint32_t offset) : parent(NULL), offset(offset) {
+            }
+
+            Environment(std::shared_ptr<Environment> parent) : parent(parent), offset(1) {
+            }
+
+            const size_t Offset() const {
+                return offset;
+            }
+
+            const size_t size() const {
+                return vars.size();
+            }
+
+            uint32_t get(const std::string &name) const {
+                auto found = vars.find(name);
+
+                if (found != vars.end()) {
+                    return found->second;
+                } else {
+                    if (parent) {
+                        return parent->get(name);
+                    } else {
+                        throw std::invalid_argument("Unknown variable `" + name + "'");
+                    }
+                }
+            }
+
+            bool isGlobal(const std::string &name) {
+                auto found = vars.find(name);
+
+                if (found != vars.end() && parent) {
+                    return false;
+                }
+
+                return true;
+            }
+
+            uint32_t create(const std::string &name, size_t count=1) {
+                auto existing = vars.find(name);
+                if (existing != vars.end()) {
+                    return existing->second;
+                }
+
+                uint32_t next = Offset() + vars.size();
+                for (size_t i = 0; i  < count; i++) {
+                    vars.insert(std::make_pair(name + std::string(i, ' '), next+i));
+                }
+                return next;
+            }
+
+            std::shared_ptr<Environment> Parent() const {
+                return parent;
+            }
+    };
+
+    // Turns parsed lines into a Program. Everything a compile needs lives
+    // in the Compiler and is cleared at the start of each compile, so
+    // separate Compilers can run on separate threads and nothing carries
+    // over from one REPL line to the next.
+    class Compiler {
+        private:
+            int current;
+            std::map<uint32_t, std::string> jumps;
+            std::stack<std::pair<uint32_t,uint32_t>> while_loops;
+            std::stack<std::tuple<uint32_t,uint32_t,std::string>> for_loops;
+            std::map<std::string, UserFunction> userfunctions;
+            std::vector<std::tuple<uint32_t, EventType, uint32_t>> events;
+            std::shared_ptr<Environment> env;
+
+            void reset();
+
+            void error(uint32_t linenumber, const std::string &err);
+            std::string identifier(uint32_t linenumber, const BasicToken &token);
+            void check(uint32_t linenumber, const BasicToken &token, BasicTokenType type, const std::string &err);
+
+            void function(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void usrfunction(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void TokenAsValue(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void Op(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void prefix(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp);
+            void expression(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens, int rbp=0);
+
+            void if_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void while_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void wend_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void for_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void next_statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void statement(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void declaration(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+            void dim_declaration(Program &program, uint32_t linenumber, const std::vector<BasicToken> &tokens);
+        public:
+            Compiler();
+
+            void compile(const std::map<uint32_t, std::vector<BasicToken>> &lines, Program &program);
+    };
 };
 
-std::pair<uint32_t, std::vector<Emulator::BasicToken>> parseLine(const std::string &line);
+std::pair<uint32_t, std::vector<Emulator::BasicToken>> parseLine(std::string_view line);
 std::map<uint32_t, std::vector<Emulator::BasicToken>> parseFile(const std::string &filename);
 
 void compile(const std::map<uint32_t, std::vector<Emulator::BasicToken>> &lines, Emulator::Program &program);
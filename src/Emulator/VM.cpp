@@ -888,10 +888,98 @@ int32_t VM::Syscall(std::shared_ptr<SysIO> sysIO, SysCall syscall, RuntimeValue
                 uint8_t sustain = getShort(ptr+4);
                 uint8_t release = getShort(ptr+5);
 
+                // Pan rides in B, centred unless VOICE was given one
+                integer_t pan = IS_INT(b) ? ValueAsInt(b) : (integer_t)ValueAsReal(b);
+
                 //std::cerr << (int)voice << "," << (int)waveForm << "," << (int)volume << "," << (int)attack << "," << (int)decay << "," << (int)sustain << "," << (int)release << std::endl;
 
-                sysIO->voice(voice, waveForm, volume, attack, decay, sustain, release);
+                sysIO->voice(voice, waveForm, volume, attack, decay, sustain, release, (uint8_t)std::clamp<integer_t>(pan, 0, UINT8_MAX));
+
+            }
+            break;
+        case SysCall::PLAY: {
+                // Tune string at IDX, voice in C
+                std::string tune;
+
+                for (vmpointer_t ptr = idx; ptr < mem.size(); ptr++) {
+                    uint8_t chr = getByte(ptr);
+
+                    if (!chr)
+                        break;
+
+                    tune += chr;
+                }
+
+                // Try again next slice while the voice's queue is full
+                if (!sysIO->play(ValueAsInt(c), tune))
+                    return 0;
+            }
+            break;
+        case SysCall::PLAYING: {
+                value_t voice = getRuntimeValue(rvalue);
+                value_t count = IntAsValue((integer_t)sysIO->playing(IS_INT(voice) ? ValueAsInt(voice) : (integer_t)ValueAsReal(voice)));
+
+                switch (rvalue) {
+                    case RuntimeValue::A:
+                        a = count;
+                        break;
+                    case RuntimeValue::B:
+                        b = count;
+                        break;
+                    case RuntimeValue::C:
+                        c = count;
+                        break;
+                    default:
+                        error("Invalid playing");
+                }
+            }
+            break;
+        case SysCall::SAMPLE: {
+                // IDX points at the sample id, the array holding the PCM,
+                // its bits and the loop start and end. As with PUT the
+                // array's first element is the count.
+                auto number = [this](vmpointer_t ptr) -> real_t {
+                    value_t value = getValue(ptr);
+
+                    if (IS_INT(value))
+                        return ValueAsInt(value);
+                    if (IS_REAL(value))
+                        return ValueAsReal(value);
+
+                    return 0;
+                };
+
+                if (!IS_POINTER(mem[idx+1]))
+                    error("SAMPLE needs an array");
+
+                vmpointer_t data = getPointer(idx+1);
+                integer_t count = (integer_t)number(data);
+
+                if (count < 0 || data + 1 + (vmpointer_t)count > mem.size())
+                    error("SAMPLE count outside memory");
+
+                bool wide = (integer_t)number(idx+2) == 16;
+                std::vector<int16_t> pcm(count);
+
+                // 8 bit samples are unsigned around 128, as in WAV files
+                for (integer_t i = 0; i < count; i++) {
+                    real_t sample = number(data + 1 + i);
+
+                    if (wide)
+                        pcm[i] = (int16_t)std::clamp<real_t>(sample, INT16_MIN, INT16_MAX);
+                    else
+                        pcm[i] = (int16_t)(((int32_t)std::clamp<real_t>(sample, 0, UINT8_MAX) - 128) * 256);
+                }
+
+                sysIO->sample((uint8_t)number(idx), std::move(pcm), (uint32_t)std::max<real_t>(number(idx+3), 0), (uint32_t)std::max<real_t>(number(idx+4), 0));
+            }
+            break;
+        case SysCall::PCM: {
+                // Sample id in A, rate in B and voice in C
+                uint8_t id = (uint8_t)(IS_INT(a) ? ValueAsInt(a) : (integer_t)ValueAsReal(a));
+                float rate = IS_INT(b) ? (float)ValueAsInt(b) : (float)ValueAsReal(b);
 
+                sysIO->pcm(ValueAsInt(c), id, rate);
             }
             break;
         case SysCall::MOUSE: {
@@ -933,7 +1021,7 @@ int32_t VM::Syscall(std::shared_ptr<SysIO> sysIO, SysCall syscall, RuntimeValue
     return 1;
 }
 
-VM::VM(uint32_t _ptrspace) : idx(0),  pc(0), sp(0), ptrspace(_ptrspace) {
+VM::VM(uint32_t _ptrspace) : idx(0),  pc(0), sp(0), ptrspace(_ptrspace), cycleCount(0) {
     a = IntAsValue(0);
     b = IntAsValue(0);
     c = IntAsValue(0);
@@ -1727,6 +1815,7 @@ bool VM::run(std::shared_ptr<SysIO> sysIO, const Program &program, uint32_t cycl
         }
 
         cycles += cost;
+        cycleCount += cost;
 
         if (cycles >= cycle_budget) {
             std::cerr << "Budget " << cycles << std::endl;
@@ -299,6 +299,10 @@ namespace Emulator {
         VOICE,
         MOUSE,
         CLOCK,
+        PLAY,
+        PLAYING,
+        SAMPLE,
+        PCM,
         COUNT
     };
 
@@ -331,7 +335,18 @@ namespace Emulator {
             virtual void blit(uint16_t x, uint16_t y, std::vector<uint8_t> buffer) = 0;
 
             virtual void sound(uint8_t voice, float frequency, uint16_t duration) = 0;
-            virtual void voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) = 0;
+            virtual void voice(uint8_t voice, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) = 0;
+
+            // Queues a tune after any already playing on the voice, false
+            // while there is no room for it yet
+            virtual bool play(uint8_t voice, const std::string &tune) = 0;
+            // Notes of the voice's tunes yet to start
+            virtual uint16_t playing(uint8_t voice) = 0;
+
+            // Keeps 16 bit PCM as sample id, loop points in samples
+            virtual void sample(uint8_t id, std::vector<int16_t> pcm, uint32_t loopStart, uint32_t loopEnd) = 0;
+            // Plays sample id on the voice at rate samples a second
+            virtual void pcm(uint8_t voice, uint8_t id, float rate) = 0;
             virtual ~SysIO() {}
     };
 
@@ -445,6 +460,8 @@ namespace Emulator {
 
             std::stack<value_t> stack;
 
+            uint64_t cycleCount;
+
             void error(const std::string &err);
 
             void set(vmpointer_t ptr, value_t v);
@@ -498,6 +515,11 @@ namespace Emulator {
                 pc = pos;
             }
 
+            // Total cycles executed since the VM was created
+            uint64_t Cycles() const {
+                return cycleCount;
+            }
+
             void addInterupt(uint32_t signal, std::function<void(VM*)> interupt) {
                 interupts[signal] = interupt;
             }
@@ -7,7 +7,6 @@
 #include <vector>
 
 #include "Math/Point2.h"
-#include "Renderer/Immediate/Font.h"
 #include "Common/Colour.h"
 #include "Common/DisplayMode.h"
 
@@ -15,6 +14,9 @@ namespace Renderer {
 
 class Base {
 public:
+    // Bands of rows as (first row, row count)
+    typedef std::vector<std::pair<uint32_t, uint32_t>> Bands;
+
     Base() {}
 
     virtual void drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour = Common::Colour::White) = 0;
@@ -25,10 +27,26 @@ public:
     virtual void drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t height, uint32_t size=1) = 0;
     virtual void drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t height, uint32_t size=1) = 0;
 
+    // Like drawBuffer(), but only the given bands of rows changed since
+    // the last call for this buffer size. Renderers that keep the
+    // previous image can update just those.
+    virtual void drawBufferRows(const uint32_t *buffer, uint32_t width, uint32_t height, const Bands &bands, uint32_t size=1) {
+        drawBuffer(buffer, width, height, size);
+    }
+
     virtual bool translatePoint(Point &screen, const Point &real) = 0;
 
     virtual void changeDisplayMode(const Common::DisplayMode &displayMode) = 0;
 
+    // Draws anything still batched up, called once a frame is complete
+    virtual void flush() {
+    }
+
+    // Renderer specific statistics for --stats, empty if there are none
+    virtual std::string report() const {
+        return std::string();
+    }
+
     virtual ~Base() {}
 };
 
@@ -0,0 +1,14 @@
+#ifndef __RENDERER_GLYPHS_H__
+#define __RENDERER_GLYPHS_H__
+
+#include <cstdint>
+
+namespace Renderer {
+    const uint32_t GlyphSize = 8;
+
+    // 8x8 bitmap for character c, row by row, set pixels are anything
+    // other than a space. Shared by every renderer that draws text.
+    const char *GlyphBitmap(uint8_t c);
+}; // namespace Renderer
+
+#endif //__RENDERER_GLYPHS_H__
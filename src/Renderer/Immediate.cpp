@@ -2,6 +2,18 @@
 
 #include <GL/glu.h>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__) && !defined(__MACOSX__)
+#include <GL/glx.h>
+#endif
 
 #define GL_RESCALE_NORMAL                       0x803A
 #define GL_CLAMP_TO_EDGE                        0x812F
@@ -47,6 +59,39 @@
 
 #define GL_CLAMP_TO_EDGE                        0x812F
 
+#define GL_STREAM_DRAW                          0x88E0
+#define GL_WRITE_ONLY                           0x88B9
+#define GL_PIXEL_UNPACK_BUFFER                  0x88EC
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// Buffer object entry points are past GL 1.1 so have to be looked up at
+// runtime, they stay null where pixel buffer objects are not available.
+typedef void (APIENTRY *GenBuffersProc)(GLsizei n, GLuint *buffers);
+typedef void (APIENTRY *DeleteBuffersProc)(GLsizei n, const GLuint *buffers);
+typedef void (APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *BufferDataProc)(GLenum target, ptrdiff_t size, const void *data, GLenum usage);
+typedef void *(APIENTRY *MapBufferProc)(GLenum target, GLenum access);
+typedef GLboolean (APIENTRY *UnmapBufferProc)(GLenum target);
+
+static GenBuffersProc genBuffers = NULL;
+static DeleteBuffersProc deleteBuffers = NULL;
+static BindBufferProc bindBuffer = NULL;
+static BufferDataProc bufferData = NULL;
+static MapBufferProc mapBuffer = NULL;
+static UnmapBufferProc unmapBuffer = NULL;
+
+static void *getProcAddress(const char *name) {
+#if defined(_WIN32)
+    return (void *)wglGetProcAddress(name);
+#elif !defined(__EMSCRIPTEN__) && !defined(__MACOSX__)
+    return (void *)glXGetProcAddressARB((const GLubyte *)name);
+#else
+    return NULL;
+#endif
+}
 
 using namespace Renderer;
 
@@ -55,7 +100,7 @@ static bool isPowerOfTwo(int x) {
     return (x != 0) && ((x & (x - 1)) == 0);
 }
 
-Immediate::Immediate(const Common::DisplayMode &displayMode, Common::AspectRatio ratio, int resolutionScale) : mode(Mode::Unknown), displayMode(displayMode), ratio(ratio), resolutionScale(resolutionScale) {
+Immediate::Immediate(const Common::DisplayMode &displayMode, Common::AspectRatio ratio, int resolutionScale) : mode(Mode::Unknown), displayMode(displayMode), ratio(ratio), resolutionScale(resolutionScale), probed(false), pixelBufferObjects(false), uploads(0), uploadRows(0), uploadTime(0), longestUpload(0) {
     if (!isPowerOfTwo(resolutionScale)) {
         std::cerr << "Invalid resolution scale" << std::endl;
         exit(-1);
@@ -204,25 +249,41 @@ void Immediate::enableDrawMode() {
 void Immediate::drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour) {
     enableInterfaceMode();
 
-    glColor4ub(colour.R(), colour.G(), colour.B(), colour.A());
-    font.drawString(((horizontalRatio*x)+horizontalOffset)*interfaceScale, ((verticalRatio*y)+verticalOffset)*interfaceScale, (w*horizontalRatio)*interfaceScale, (h*verticalRatio)*interfaceScale, str);
+    font.drawString(((horizontalRatio*x)+horizontalOffset)*interfaceScale, ((verticalRatio*y)+verticalOffset)*interfaceScale, (w*horizontalRatio)*interfaceScale, (h*verticalRatio)*interfaceScale, str, colour);
+}
+
+void Immediate::flush() {
+    if (!font.pending())
+        return;
+
+    // Text is queued in interface coordinates, make sure they apply
+    enableInterfaceMode();
+    font.flush();
 }
 
 void Immediate::drawRect(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const Common::Colour &colour) {
+    flush();
     enableInterfaceMode();
 
     glDisable(GL_TEXTURE_2D);
     glColor4ub(colour.R(), colour.G(), colour.B(), colour.A());
 
+    // Same virtual screen coordinates as drawString()
+    GLfloat left = ((horizontalRatio*x)+horizontalOffset)*interfaceScale;
+    GLfloat top = ((verticalRatio*y)+verticalOffset)*interfaceScale;
+    GLfloat width = (w*horizontalRatio)*interfaceScale;
+    GLfloat height = (h*verticalRatio)*interfaceScale;
+
     glBegin(GL_QUADS);
-        glTexCoord2f(0, 0); glVertex2f(x, y);
-        glTexCoord2f(1, 0); glVertex2f(x + w, y);
-        glTexCoord2f(1, 1); glVertex2f(x + w, y + h);
-        glTexCoord2f(0, 1); glVertex2f(x, y + h);
+        glTexCoord2f(0, 0); glVertex2f(left, top);
+        glTexCoord2f(1, 0); glVertex2f(left + width, top);
+        glTexCoord2f(1, 1); glVertex2f(left + width, top + height);
+        glTexCoord2f(0, 1); glVertex2f(left, top + height);
     glEnd();
 }
 
 void Immediate::drawQuad(const Vec2d &a, const Vec2d &b, const Vec2d &c, const Vec2d &d, const Common::Colour &colour) {
+    flush();
     enableInterfaceMode();
 
     glDisable(GL_TEXTURE_2D);
@@ -237,6 +298,7 @@ void Immediate::drawQuad(const Vec2d &a, const Vec2d &b, const Vec2d &c, const V
 }
 
 void Immediate::drawLine(const Vec2d &start, const Vec2d &end, const Common::Colour &colour) {
+    flush();
     enableInterfaceMode();
 
     glDisable(GL_TEXTURE_2D);
@@ -248,6 +310,7 @@ void Immediate::drawLine(const Vec2d &start, const Vec2d &end, const Common::Col
 }
 
 void Immediate::drawPoint(const uint16_t x, const uint16_t y, const Common::Colour &colour, const uint16_t size) {
+    flush();
     enableInterfaceMode();
 
     glPointSize(size);
@@ -258,20 +321,149 @@ void Immediate::drawPoint(const uint16_t x, const uint16_t y, const Common::Colo
     glEnd();
 }
 
+void Immediate::probePixelBufferObjects() {
+    probed = true;
+
+    const char *version = (const char *)glGetString(GL_VERSION);
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+
+    int major = 0;
+    int minor = 0;
+    if (version)
+        sscanf(version, "%d.%d", &major, &minor);
+
+    bool supported = (major > 2 || (major == 2 && minor >= 1)) || (extensions && strstr(extensions, "GL_ARB_pixel_buffer_object"));
+    if (!supported)
+        return;
+
+    genBuffers = (GenBuffersProc)getProcAddress("glGenBuffers");
+    deleteBuffers = (DeleteBuffersProc)getProcAddress("glDeleteBuffers");
+    bindBuffer = (BindBufferProc)getProcAddress("glBindBuffer");
+    bufferData = (BufferDataProc)getProcAddress("glBufferData");
+    mapBuffer = (MapBufferProc)getProcAddress("glMapBuffer");
+    unmapBuffer = (UnmapBufferProc)getProcAddress("glUnmapBuffer");
+
+    pixelBufferObjects = genBuffers && deleteBuffers && bindBuffer && bufferData && mapBuffer && unmapBuffer;
+}
+
+GLuint Immediate::upload(const void *buffer, uint32_t width, uint32_t height, GLint internalFormat, GLenum format, GLenum type, uint32_t bytesPerPixel, const Bands &changed) {
+    if (!probed)
+        probePixelBufferObjects();
+
+    Bands everything = {{0, height}};
+    const Bands *bands = &changed;
+
+    auto key = std::make_tuple(width, height, format);
+    auto found = textures.find(key);
+
+    if (found == textures.end()) {
+        StreamingTexture created = {0, {0, 0}, 0};
+
+        glGenTextures(1, &created.texture);
+        glBindTexture(GL_TEXTURE_2D, created.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+
+        if (pixelBufferObjects)
+            genBuffers(created.pixelBuffers.size(), created.pixelBuffers.data());
+
+        found = textures.emplace(key, created).first;
+
+        // A new texture has no contents yet, so it needs everything
+        bands = &everything;
+    }
+
+    StreamingTexture &streaming = found->second;
+    size_t stride = (size_t)width * bytesPerPixel;
+
+    glBindTexture(GL_TEXTURE_2D, streaming.texture);
+
+    size_t size = 0;
+    for (const auto &band : *bands) {
+        if (band.first < height)
+            size += std::min(band.second, height - band.first) * stride;
+    }
+
+    if (size == 0)
+        return streaming.texture;
+
+    auto start = std::chrono::steady_clock::now();
+
+    uint8_t *mapped = NULL;
+    if (pixelBufferObjects) {
+        // Alternate between two buffers and orphan the storage before
+        // mapping, so the driver never has to wait for the previous
+        // frame's transfer to finish before we can write the next one.
+        bindBuffer(GL_PIXEL_UNPACK_BUFFER, streaming.pixelBuffers[streaming.next]);
+        bufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+        mapped = (uint8_t *)mapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        streaming.next = (streaming.next + 1) % streaming.pixelBuffers.size();
+    }
+
+    if (mapped) {
+        // Pack all bands into the one buffer, then source each
+        // sub-image from its offset within it.
+        size_t offset = 0;
+        for (const auto &band : *bands) {
+            if (band.first >= height)
+                continue;
+
+            uint32_t count = std::min(band.second, height - band.first);
+            memcpy(mapped + offset, (const uint8_t *)buffer + band.first * stride, count * stride);
+            offset += count * stride;
+        }
+
+        unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        offset = 0;
+        for (const auto &band : *bands) {
+            if (band.first >= height)
+                continue;
+
+            uint32_t count = std::min(band.second, height - band.first);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, band.first, width, count, format, type, (const void *)offset);
+            offset += count * stride;
+        }
+    } else {
+        for (const auto &band : *bands) {
+            if (band.first >= height)
+                continue;
+
+            uint32_t count = std::min(band.second, height - band.first);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, band.first, width, count, format, type, (const uint8_t *)buffer + band.first * stride);
+        }
+    }
+
+    if (pixelBufferObjects)
+        bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    uploads++;
+    uploadRows += size / stride;
+    uploadTime += elapsed;
+    longestUpload = std::max(longestUpload, elapsed);
+
+    return streaming.texture;
+}
+
 void Immediate::drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t height, uint32_t size) {
+    drawBufferRows(buffer, width, height, {{0, height}}, size);
+}
+
+void Immediate::drawBufferRows(const uint32_t *buffer, uint32_t width, uint32_t height, const Bands &bands, uint32_t size) {
+    flush();
     enableDrawMode();
 
     glEnable(GL_BLEND);
 
-    GLuint screen;
-    glGenTextures(1, &screen);
+    upload(buffer, width, height, GL_RGBA, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, 4, bands);
+    drawScreen(size);
+}
 
-    glBindTexture(GL_TEXTURE_2D, screen);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, buffer);
+void Immediate::drawScreen(uint32_t size) {
     glEnable(GL_TEXTURE_2D);
 
     int toffset = verticalOffset;
@@ -342,24 +534,15 @@ void Immediate::drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t heig
             glVertex3i(0, VHEIGHT, 0);
         glEnd();
     }
-
-    glDeleteTextures(1, &screen);
 }
 
 void Immediate::drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t height, uint32_t size) {
+    flush();
     enableDrawMode();
 
     glEnable(GL_BLEND);
 
-    GLuint screen;
-    glGenTextures(1, &screen);
-
-    glBindTexture(GL_TEXTURE_2D, screen);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R3_G3_B2, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE_3_3_2, buffer);
+    upload(buffer, width, height, GL_R3_G3_B2, GL_RGB, GL_UNSIGNED_BYTE_3_3_2, 1, {{0, height}});
     glEnable(GL_TEXTURE_2D);
 
     int toffset = verticalOffset;
@@ -430,8 +613,6 @@ void Immediate::drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t heigh
             glVertex3i(0, VHEIGHT, 0);
         glEnd();
     }
-
-    glDeleteTextures(1, &screen);
 }
 
 
@@ -464,6 +645,26 @@ bool Immediate::translatePoint(Point &screen, const Point &real) {
     return true;
 }
 
+std::string Immediate::report() const {
+    std::ostringstream s;
+
+    s << std::fixed << std::setprecision(3);
+    s << "Upload: " << uploads << " frames via " << (pixelBufferObjects ? "pixel buffers" : "client memory");
+
+    if (uploads) {
+        s << ", mean " << (double)uploadTime / uploads / 1000000.0 << "ms";
+        s << " for " << (double)uploadRows / uploads << " rows";
+        s << ", max " << longestUpload / 1000000.0 << "ms";
+    }
+
+    return s.str();
+}
+
 Immediate::~Immediate() {
+    for (auto &entry : textures) {
+        glDeleteTextures(1, &entry.second.texture);
 
+        if (pixelBufferObjects)
+            deleteBuffers(entry.second.pixelBuffers.size(), entry.second.pixelBuffers.data());
+    }
 }
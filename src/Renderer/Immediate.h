@@ -4,9 +4,12 @@
 #include <cstdint>
 #include <array>
 #include <string>
+#include <map>
+#include <tuple>
 
 #include "Common/DisplayMode.h"
 #include "Renderer/Base.h"
+#include "Renderer/Immediate/Font.h"
 
 namespace Renderer {
 
@@ -41,6 +44,28 @@ class Immediate : public Base {
     float verticalRatio;
 
     float interfaceScale;
+
+    // Screen textures live for the life of the renderer, one per size
+    // and pixel format, and are refreshed in place every frame.
+    struct StreamingTexture {
+        GLuint texture;
+        std::array<GLuint, 2> pixelBuffers;
+        uint32_t next;
+    };
+
+    std::map<std::tuple<uint32_t, uint32_t, GLenum>, StreamingTexture> textures;
+
+    bool probed;
+    bool pixelBufferObjects;
+
+    uint64_t uploads;
+    uint64_t uploadRows;
+    int64_t uploadTime;
+    int64_t longestUpload;
+
+    void probePixelBufferObjects();
+    GLuint upload(const void *buffer, uint32_t width, uint32_t height, GLint internalFormat, GLenum format, GLenum type, uint32_t bytesPerPixel, const Bands &bands);
+    void drawScreen(uint32_t size);
 public:
     Immediate(const Common::DisplayMode &displayMode, Common::AspectRatio ratio=Common::AspectRatio::_4x3, int resolutionScale=1);
     void drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour = Common::Colour::White);
@@ -50,11 +75,16 @@ public:
     void drawLine(const Vec2d &start, const Vec2d &end, const Common::Colour &colour);
     void drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t height, uint32_t size=1);
     void drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t height, uint32_t size=1);
+    void drawBufferRows(const uint32_t *buffer, uint32_t width, uint32_t height, const Bands &bands, uint32_t size=1);
 
     bool translatePoint(Point &screen, const Point &real);
 
     void changeDisplayMode(const Common::DisplayMode &displayMode);
 
+    void flush();
+
+    std::string report() const;
+
     ~Immediate();
 };
 
@@ -2,2691 +2,104 @@
 #include <cstdint>
 
 #include <algorithm>
+#include <vector>
 
 #include <iostream>
 
 #define GL_CLAMP_TO_EDGE                        0x812F
 
 #include "Renderer/Immediate/Font.h"
+#include "Renderer/Glyphs.h"
 
 using namespace Renderer;
 //using namespace Immediate;
 
-static const char *nulpixelbitmap = 
-    "        "
-    "        "
-    "        "
-    "        "
-    "        "
-    "        "
-    "        "
-    "        ";
-   
-static const char *blockpixelbitmap = 
-"11111111"
-"11111111"
-"11111111"
-"11111111"
-"11111111"
-"11111111"
-"11111111"
-"11111111";
-
-
-static const char *pixelbitmaps[] = {
-// (0)
-"        "
-"        "
-"        "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// (1)
-"   11   "
-"  1111  "
-" 11  11 "
-"11    11"
-"111  111"
-"  1  1  "
-"  1  1  "
-"  1111  ",
-
-// (2)
-"  1111  "
-"  1  1  "
-"  1  1  "
-"111  111"
-"11    11"
-" 11  11 "
-"  1111  "
-"   11   ",
-
-// (3)
-"   11   "
-"   111  "
-"1111 11 "
-"1     11"
-"1     11"
-"1111 11 "
-"   111  "
-"   11   ",
-
-// (4)
-"   11   "
-"  111   "
-" 11 1111"
-"11     1"
-"11     1"
-" 11 1111"
-"  111   "
-"   11   ",
-
-// (5)
-"  1111  "
-"1  11  1"
-"11    11"
-"111  111"
-"11    11"
-"1  11  1"
-"  1111  "
-"        ",
-
-// (6)
-"11111111"
-"11111111"
-"1111111 "
-"111111  "
-"11111  1"
-"1111  11"
-"111  111"
-"        ",
-
-// (7)
-"111  111"
-"11    11"
-"1  11  1"
-"  1111  "
-"1  11  1"
-"11    11"
-"111  111"
-"        ",
-
-// (8)
-"       1"
-"      11"
-"     11 "
-"1   11  "
-"11 11   "
-" 111    "
-"  1     "
-"        ",
-
-// (9)
-" 111111 "
-"11    11"
-"11 1  11"
-"11 1  11"
-"11 11 11"
-"11    11"
-"11    11"
-" 111111 ",
-
-// (10)
-"   11   "
-"  1111  "
-"  1111  "
-"  1111  "
-" 111111 "
-"   1    "
-"  111   "
-"   1    ",
-
-// (11)
-"   11   "
-"   111  "
-"   1 11 "
-"   1    "
-"   1    "
-" 111    "
-"1111    "
-" 11     ",
-
-// (12)
-"1111    "
-"11      "
-"1111111 "
-"11 11   "
-"11 1111 "
-"   11   "
-"   11   "
-"        ",
-
-// (13)
-"1111    "
-"11      "
-"11 11111"
-"11 11 11"
-"11111111"
-"   1111 "
-"   11 11"
-"        ",
-
-// (14)
-"     1 1"
-"     1 1"
-"     1 1"
-"    11 1"
-"    11 1"
-"   11  1"
-" 1111  1"
-" 111   1",
-
-// (15)
-"1 1     "
-"1 1     "
-"1 1     "
-"1 11    "
-"1 11    "
-"1  11   "
-"1  1111 "
-"1   111 ",
-
-// (16)
-" 11111  "
-"11   11 "
-"11   11 "
-"        "
-"11   11 "
-"11   11 "
-" 11111  "
-"        ",
-
-// (17)
-"     11 "
-"     11 "
-"     11 "
-"        "
-"     11 "
-"     11 "
-"     11 "
-"        ",
-
-// (18)
-" 11111  "
-"     11 "
-"     11 "
-" 11111  "
-"11      "
-"11      "
-" 11111  "
-"        ",
-
-// (19)
-" 11111  "
-"     11 "
-"     11 "
-" 11111  "
-"     11 "
-"     11 "
-" 11111  "
-"        ",
-
-// (20)
-"11   11 "
-"11   11 "
-"11   11 "
-" 11111  "
-"     11 "
-"     11 "
-"     11 "
-"        ",
-
-// (21)
-" 11111  "
-"11      "
-"11      "
-" 11111  "
-"     11 "
-"     11 "
-" 11111  "
-"        ",
-
-// (22)
-" 11111  "
-"11      "
-"11      "
-" 11111  "
-"11   11 "
-"11   11 "
-" 11111  "
-"        ",
-
-// (23)
-" 11111  "
-"     11 "
-"     11 "
-"        "
-"     11 "
-"     11 "
-"     11 "
-"        ",
-
-// (24)
-" 11111  "
-"11   11 "
-"11   11 "
-" 11111  "
-"11   11 "
-"11   11 "
-" 11111  "
-"        ",
-
-// (25)
-" 11111  "
-"11   11 "
-"11   11 "
-" 11111  "
-"     11 "
-"     11 "
-" 11111  "
-"        ",
-
-// (26)
-"        "
-"        "
-"  1111  "
-"     11 "
-" 111111 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (27)
-" 1111   "
-" 11     "
-" 1111   "
-" 11     "
-" 111111 "
-"   11   "
-"   1111 "
-"        ",
-
-// (28)
-"     111"
-"    1111"
-"   11111"
-"   11   "
-"   11   "
-"   1    "
-"   1111 "
-"   1 111",
-
-// (29)
-"1111    "
-"11111   "
-"111 11  "
-"     1  "
-"     1  "
-"     1  "
-"  1111  "
-" 1 1 1  ",
-
-// (30)
-"   1   1"
-"    1 11"
-"    11 1"
-"     11 "
-"     111"
-"  1 111 "
-"  111  1"
-"  111   ",
-
-// (31)
-"     1  "
-"  1 1   "
-"11 11   "
-"  1 1   "
-"11 1    "
-"   1    "
-"111     "
-"        ",
-
-//  
-"        "
-"        "
-"        "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// !
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"        "
-"   11   "
-"        ",
-
-// "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// #
-"        "
-" 11 11  "
-"1111111 "
-" 11 11  "
-" 11 11  "
-"1111111 "
-" 11 11  "
-"        ",
-
-// $
-"   11   "
-"  11111 "
-" 11     "
-"  1111  "
-"     11 "
-" 11111  "
-"   11   "
-"        ",
-
-// %
-"        "
-" 11  11 "
-" 11 11  "
-"   11   "
-"  11    "
-" 11  11 "
-" 1   11 "
-"        ",
-
-// &
-"  111   "
-" 11 11  "
-"  111   "
-" 111    "
-"11 1111 "
-"11  11  "
-" 111 11 "
-"        ",
-
-// '
-"   11   "
-"   11   "
-"   11   "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// (
-"    111 "
-"   111  "
-"   11   "
-"   11   "
-"   11   "
-"   111  "
-"    111 "
-"        ",
-
-// )
-" 111    "
-"  111   "
-"   11   "
-"   11   "
-"   11   "
-"  111   "
-" 111    "
-"        ",
-
-// *
-"        "
-" 11  11 "
-"  1111  "
-"11111111"
-"  1111  "
-" 11  11 "
-"        "
-"        ",
-
-// +
-"        "
-"   11   "
-"   11   "
-" 111111 "
-"   11   "
-"   11   "
-"        "
-"        ",
-
-// ,
-"        "
-"        "
-"        "
-"        "
-"        "
-"  11    "
-"  11    "
-" 11     ",
-
-// -
-"        "
-"        "
-"        "
-" 111111 "
-"        "
-"        "
-"        "
-"        ",
-
-// .
-"        "
-"        "
-"        "
-"        "
-"        "
-"   11   "
-"   11   "
-"        ",
-
-// /
-"      1 "
-"     11 "
-"    11  "
-"   11   "
-"  11    "
-" 11     "
-" 1      "
-"        ",
-
-// 0
-"  1111  "
-" 11  11 "
-" 11 111 "
-" 111 11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// 1
-"   11   "
-"  111   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-" 111111 "
-"        ",
-
-// 2
-"  1111  "
-" 11  11 "
-"     11 "
-"    11  "
-"   11   "
-"  11    "
-" 111111 "
-"        ",
-
-// 3
-" 111111 "
-"    11  "
-"   11   "
-"    11  "
-"     11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// 4
-"    11  "
-"   111  "
-"  1111  "
-" 11 11  "
-" 111111 "
-"    11  "
-"    11  "
-"        ",
-
-// 5
-" 111111 "
-" 11     "
-" 11111  "
-"     11 "
-"     11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// 6
-"  1111  "
-" 11     "
-" 11     "
-" 11111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// 7
-" 111111 "
-"     11 "
-"    11  "
-"   11   "
-"  11    "
-"  11    "
-"  11    "
-"        ",
-
-// 8
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// 9
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"     11 "
-"    11  "
-"  111   "
-"        ",
-
-// :
-"        "
-"   11   "
-"   11   "
-"        "
-"   11   "
-"   11   "
-"        "
-"        ",
-
-// ;
-"        "
-"   11   "
-"   11   "
-"        "
-"   11   "
-"   11   "
-"  11    "
-"        ",
-
-// <
-"     11 "
-"    11  "
-"   11   "
-"  11    "
-"   11   "
-"    11  "
-"     11 "
-"        ",
-
-// =
-"        "
-"        "
-" 111111 "
-"        "
-"        "
-" 111111 "
-"        "
-"        ",
-
-// >
-" 11     "
-"  11    "
-"   11   "
-"    11  "
-"   11   "
-"  11    "
-" 11     "
-"        ",
-
-// ?
-"  1111  "
-" 11  11 "
-"     11 "
-"    11  "
-"   11   "
-"        "
-"   11   "
-"        ",
-
-// @
-"  1111  "
-" 11  11 "
-" 11 111 "
-" 11 1 1 "
-" 11 111 "
-" 11     "
-"  11111 "
-"        ",
-
-// A
-"   11   "
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 111111 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// B
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11111  "
-"        ",
-
-// C
-"  1111  "
-" 11  11 "
-" 11     "
-" 11     "
-" 11     "
-" 11  11 "
-"  1111  "
-"        ",
-
-// D
-" 1111   "
-" 11 11  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11 11  "
-" 1111   "
-"        ",
-
-// E
-" 111111 "
-" 11     "
-" 11     "
-" 11111  "
-" 11     "
-" 11     "
-" 111111 "
-"        ",
-
-// F
-" 111111 "
-" 11     "
-" 11     "
-" 11111  "
-" 11     "
-" 11     "
-" 11     "
-"        ",
-
-// G
-"  11111 "
-" 11     "
-" 11     "
-" 11 111 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// H
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 111111 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// I
-"  1111  "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// J
-"     11 "
-"     11 "
-"     11 "
-"     11 "
-"     11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// K
-" 11  11 "
-" 11 11  "
-" 1111   "
-" 111    "
-" 1111   "
-" 11 11  "
-" 11  11 "
-"        ",
-
-// L
-" 11     "
-" 11     "
-" 11     "
-" 11     "
-" 11     "
-" 11     "
-" 111111 "
-"        ",
-
-// M
-"11   11 "
-"111 111 "
-"1111111 "
-"11 1 11 "
-"11   11 "
-"11   11 "
-"11   11 "
-"        ",
-
-// N
-" 11  11 "
-" 111 11 "
-" 111111 "
-" 111111 "
-" 11 111 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// O
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// P
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11111  "
-" 11     "
-" 11     "
-" 11     "
-"        ",
-
-// Q
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 111 11 "
-" 11 11  "
-"  11 11 "
-"        ",
-
-// R
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11111  "
-" 11 11  "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// S
-"  1111  "
-" 11  11 "
-" 11     "
-"  1111  "
-"     11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// T
-" 111111 "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"        ",
-
-// U
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// V
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"   11   "
-"        ",
-
-// W
-"11   11 "
-"11   11 "
-"11   11 "
-"11 1 11 "
-"1111111 "
-"111 111 "
-"11   11 "
-"        ",
-
-// X
-" 11  11 "
-" 11  11 "
-"  1111  "
-"   11   "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// Y
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"   11   "
-"   11   "
-"   11   "
-"        ",
-
-// Z
-" 111111 "
-"     11 "
-"    11  "
-"   11   "
-"  11    "
-" 11     "
-" 111111 "
-"        ",
-
-// [
-"   1111 "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   1111 "
-"        ",
-
-// '\'
-" 1      "
-" 11     "
-"  11    "
-"   11   "
-"    11  "
-"     11 "
-"      1 "
-"        ",
-
-// ]
-" 1111   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-" 1111   "
-"        ",
-
-// ^
-"   1    "
-"  111   "
-" 11 11  "
-"11   11 "
-"        "
-"        "
-"        "
-"        ",
-
-// _
-"        "
-"        "
-"        "
-"        "
-"        "
-"        "
-"1111111 "
-"        ",
-
-// `
-"        "
-"11      "
-" 11     "
-"  11    "
-"        "
-"        "
-"        "
-"        ",
-
-// a
-"        "
-"        "
-"  1111  "
-"     11 "
-"  11111 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// b
-" 11     "
-" 11     "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11111  "
-"        ",
-
-// c
-"        "
-"        "
-"  1111  "
-" 11     "
-" 11     "
-" 11     "
-"  1111  "
-"        ",
-
-// d
-"     11 "
-"     11 "
-"  11111 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// e
-"        "
-"        "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11     "
-"  1111  "
-"        ",
-
-// f
-"   111  "
-"  11    "
-" 11111  "
-"  11    "
-"  11    "
-"  11    "
-"  11    "
-"        ",
-
-// g
-"        "
-"        "
-"  11111 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"     11 "
-" 11111  ",
-
-// h
-" 11     "
-" 11     "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// i
-"   11   "
-"        "
-"  111   "
-"   11   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// j
-"   11   "
-"        "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-" 111    ",
-
-// k
-" 11     "
-" 11     "
-" 11  11 "
-" 11 11  "
-" 1111   "
-" 11 11  "
-" 11  11 "
-"        ",
-
-// l
-"  111   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// m
-"        "
-"        "
-"111 11  "
-"1111111 "
-"11 1 11 "
-"11   11 "
-"11   11 "
-"        ",
-
-// n
-"        "
-"        "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// o
-"        "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// p
-"        "
-"        "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11111  "
-" 11     ",
-
-// q
-"        "
-"        "
-"  11111 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"     11 ",
-
-// r
-"        "
-"        "
-" 11111  "
-" 11  11 "
-" 11     "
-" 11     "
-" 11     "
-"        ",
-
-// s
-"        "
-"        "
-"  11111 "
-" 11     "
-"  1111  "
-"     11 "
-" 11111  "
-"        ",
-
-// t
-"        "
-"   11   "
-" 111111 "
-"   11   "
-"   11   "
-"   11   "
-"    111 "
-"        ",
-
-// u
-"        "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// v
-"        "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"   11   "
-"        ",
-
-// w
-"        "
-"        "
-"11   11 "
-"11   11 "
-"11 1 11 "
-" 11111  "
-" 11 11  "
-"        ",
-
-// x
-"        "
-"        "
-" 11  11 "
-"  1111  "
-"   11   "
-"  1111  "
-" 11  11 "
-"        ",
-
-// y
-"        "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"     11 "
-" 11111  ",
-
-// z
-"        "
-"        "
-" 111111 "
-"    11  "
-"   11   "
-"  11    "
-" 111111 "
-"        ",
-
-// {
-"    111 "
-"   11   "
-"   11   "
-"  11    "
-"   11   "
-"   11   "
-"    111 "
-"        ",
-
-// |
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   ",
-
-// }
-" 111    "
-"   11   "
-"   11   "
-"    11  "
-"   11   "
-"   11   "
-" 111    "
-"        ",
-
-// ~
-"        "
-" 11     "
-"1111  1 "
-"1  1111 "
-"    11  "
-"        "
-"        "
-"        ",
-
-// (127)
-"        "
-"   11   "
-"   11   "
-"  11 1  "
-"  11 1  "
-" 11   1 "
-" 111111 "
-"        ",
-
-// (128)
-"        "
-"  1111  "
-" 11  11 "
-" 11     "
-" 11  11 "
-"  1111  "
-"    1   "
-"  111   ",
-
-// (129)
-" 11  11 "
-"        "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// (130)
-"    11  "
-"   11   "
-"        "
-"  1111  "
-" 111111 "
-" 11     "
-"  1111  "
-"        ",
-
-// (131)
-"   11   "
-" 11  11 "
-"        "
-"  1111  "
-"     11 "
-" 111111 "
-"  11111 "
-"        ",
-
-// (132)
-" 11  11 "
-"        "
-"  1111  "
-"     11 "
-"  11111 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// (133)
-"  11    "
-"   11   "
-"        "
-"  1111  "
-"     11 "
-" 111111 "
-"  11111 "
-"        ",
-
-// (134)
-"   11   "
-"   11   "
-"        "
-"  1111  "
-"     11 "
-" 111111 "
-"  11111 "
-"        ",
-
-// (135)
-"        "
-"        "
-"  1111  "
-" 11     "
-" 11     "
-"  1111  "
-"    1   "
-"   11   ",
-
-// (136)
-"   11   "
-" 11  11 "
-"        "
-"  1111  "
-" 111111 "
-" 11     "
-"  1111  "
-"        ",
-
-// (137)
-" 11  11 "
-"        "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11     "
-"  1111  "
-"        ",
-
-// (138)
-"  11    "
-"   11   "
-"        "
-"  1111  "
-" 111111 "
-" 11     "
-"  1111  "
-"        ",
-
-// (139)
-" 11  11 "
-"        "
-"        "
-"  111   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// (140)
-"   11   "
-" 11  11 "
-"        "
-"  111   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// (141)
-" 11     "
-"  11    "
-"        "
-"  111   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// (142)
-" 11  11 "
-"        "
-"   11   "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11  11 "
-"        ",
-
-// (143)
-"   11   "
-"        "
-"   11   "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11  11 "
-"        ",
-
-// (144)
-"    11  "
-"   11   "
-" 111111 "
-" 11     "
-" 11111  "
-" 11     "
-" 111111 "
-"        ",
-
-// (145)
-"        "
-"        "
-" 111111 "
-"   11 11"
-" 1111111"
-"11 11   "
-" 111111 "
-"        ",
-
-// (146)
-"  111111"
-" 1111   "
-"11 11   "
-"11 1111 "
-"11111   "
-"11 11   "
-"11 11111"
-"        ",
-
-// (147)
-"   11   "
-" 11  11 "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (148)
-" 11  11 "
-"        "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (149)
-"  11    "
-"   11   "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (150)
-"   11   "
-" 11  11 "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// (151)
-"  11    "
-"   11   "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// (152)
-" 11  11 "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"     11 "
-" 11111  ",
-
-// (153)
-" 11  11 "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (154)
-" 11  11 "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// (155)
-"   11   "
-"   11   "
-"  1111  "
-" 11     "
-" 11     "
-"  1111  "
-"   11   "
-"   11   ",
-
-// (156)
-"   111  "
-"  111 1 "
-"  11    "
-" 11111  "
-"  11    "
-"  11    "
-" 111111 "
-"        ",
-
-// (157)
-" 11  11 "
-" 11  11 "
-"  1111  "
-"   11   "
-"  1111  "
-"   11   "
-"   11   "
-"        ",
-
-// (158)
-"   111  "
-"  11 11 "
-" 11  11 "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11111  "
-" 11     ",
-
-// (159)
-"   1111 "
-"  11    "
-" 11111  "
-"  11    "
-"  11    "
-"  11    "
-" 11     "
-"        ",
-
-// (160)
-"    11  "
-"   11   "
-"        "
-"  1111  "
-"     11 "
-" 111111 "
-"  11111 "
-"        ",
-
-// (161)
-"    11  "
-"   11   "
-"        "
-"  111   "
-"   11   "
-"   11   "
-"  1111  "
-"        ",
-
-// (162)
-"    11  "
-"   11   "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (163)
-"    11  "
-"   11   "
-"        "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  11111 "
-"        ",
-
-// (164)
-"  11 1  "
-" 1 11   "
-"        "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// (165)
-"  11 1  "
-" 1 11   "
-"        "
-" 11  11 "
-" 111 11 "
-" 11 111 "
-" 11  11 "
-"        ",
-
-// (166)
-"        "
-"  1111  "
-"     11 "
-"  11111 "
-" 11  11 "
-"  11111 "
-"        "
-"  1111  ",
-
-// (167)
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        "
-"  1111  ",
-
-// (168)
-"        "
-"   11   "
-"        "
-"   11   "
-"  11    "
-" 11     "
-" 11  11 "
-"  1111  ",
-
-// (169)
-"        "
-"        "
-"        "
-"  11111 "
-"  11    "
-"  11    "
-"  11    "
-"        ",
-
-// (170)
-"        "
-"        "
-"        "
-" 11111  "
-"    11  "
-"    11  "
-"    11  "
-"        ",
-
-// (171)
-"11   11 "
-"11  11  "
-"11 11   "
-"  11 11 "
-" 11 1 11"
-"11    11"
-"1    11 "
-"    1111",
-
-// (172)
-"11   11 "
-"11  11  "
-"11 11   "
-"  11 11 "
-" 11 111 "
-"11 1 11 "
-"1  11111"
-"     11 ",
-
-// (173)
-"        "
-"   11   "
-"        "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   11   ",
-
-// (174)
-"   11 11"
-"  11 11 "
-" 11 11  "
-"11 11   "
-" 11 11  "
-"  11 11 "
-"   11 11"
-"        ",
-
-// (175)
-"11 11   "
-" 11 11  "
-"  11 11 "
-"   11 11"
-"  11 11 "
-" 11 11  "
-"11 11   "
-"        ",
-
-// (176)
-"  11 1  "
-" 1 11   "
-"        "
-"  1111  "
-"     11 "
-" 111111 "
-"  11111 "
-"        ",
-
-// (177)
-"  11 1  "
-" 1 11   "
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (178)
-"      1 "
-"  1111  "
-" 11  11 "
-" 11 111 "
-" 111 11 "
-" 11  11 "
-"  1111  "
-" 1      ",
-
-// (179)
-"        "
-"      1 "
-"  1111  "
-" 11 111 "
-" 111 11 "
-" 11  11 "
-"  1111  "
-" 1      ",
-
-// (180)
-"        "
-"        "
-" 111111 "
-"11 11 11"
-"11 11111"
-"11 11   "
-" 111111 "
-"        ",
-
-// (181)
-" 1111111"
-"11 11   "
-"11 11   "
-"11 1111 "
-"11 11   "
-"11 11   "
-" 1111111"
-"        ",
-
-// (182)
-"  11    "
-"   11   "
-"        "
-"   11   "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11  11 ",
-
-// (183)
-"  11 1  "
-" 1 11   "
-"        "
-"   11   "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11  11 ",
-
-// (184)
-"  11 1  "
-" 1 11   "
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1111  ",
-
-// (185)
-" 11  11 "
-"        "
-"        "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// (186)
-"    11  "
-"   11   "
-"  11    "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// (187)
-"        "
-"   1    "
-"  111   "
-"   1    "
-"   1    "
-"   1    "
-"        "
-"        ",
-
-// (188)
-" 1111 1 "
-"11  1 1 "
-"11  1 1 "
-"11  1 1 "
-" 1111 1 "
-"    1 1 "
-"    1 1 "
-"    1 1 ",
-
-// (189)
-" 111111 "
-"11    11"
-"1 1111 1"
-"1 11   1"
-"1 11   1"
-"1 1111 1"
-"11    11"
-" 111111 ",
-
-// (190)
-" 111111 "
-"11    11"
-"1 1111 1"
-"1 1  1 1"
-"1 111  1"
-"1 1 11 1"
-"11    11"
-" 111111 ",
-
-// (191)
-"1111   1"
-" 1 11 11"
-" 1 11111"
-" 1 1 1 1"
-" 1 1   1"
-"        "
-"        "
-"        ",
-
-// (192)
-" 11  11 "
-"        "
-"111  11 "
-" 11  11 "
-" 11  11 "
-"1111 11 "
-"     11 "
-"   111  ",
-
-// (193)
-"1111 11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"1111 11 "
-"     11 "
-"   111  ",
-
-// (194)
-"        "
-" 11  11 "
-" 111 11 "
-"  1111  "
-" 11 111 "
-" 11  11 "
-"        "
-"        ",
-
-// (195)
-"        "
-" 11111  "
-"    11  "
-"    11  "
-"    11  "
-" 111111 "
-"        "
-"        ",
-
-// (196)
-"        "
-"   1111 "
-"     11 "
-"    111 "
-"   1111 "
-"  11 11 "
-"        "
-"        ",
-
-// (197)
-"        "
-" 111111 "
-"    11  "
-"    11  "
-"    11  "
-"    11  "
-"        "
-"        ",
-
-// (198)
-"        "
-" 11111  "
-"     11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        "
-"        ",
-
-// (199)
-"        "
-"   111  "
-"    11  "
-"    11  "
-"    11  "
-"    11  "
-"        "
-"        ",
-
-// (200)
-"        "
-"   1111 "
-"    11  "
-"     11 "
-"     11 "
-"     11 "
-"        "
-"        ",
-
-// (201)
-"        "
-" 111111 "
-"  11 11 "
-"  11 11 "
-"  11 11 "
-"  11 11 "
-"        "
-"        ",
-
-// (202)
-" 11     "
-" 11 111 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 111111 "
-"        "
-"        ",
-
-// (203)
-"        "
-"  1111  "
-"    11  "
-"    11  "
-"        "
-"        "
-"        "
-"        ",
-
-// (204)
-"        "
-"  11111 "
-"     11 "
-"     11 "
-"     11 "
-"  11111 "
-"        "
-"        ",
-
-// (205)
-" 11     "
-" 111111 "
-"     11 "
-"     11 "
-"     11 "
-"    111 "
-"        "
-"        ",
-
-// (206)
-"        "
-" 11 11  "
-"  11111 "
-" 11  11 "
-" 11  11 "
-" 11 111 "
-"        "
-"        ",
-
-// (207)
-"        "
-"   111  "
-"    11  "
-"    11  "
-"    11  "
-"  1111  "
-"        "
-"        ",
-
-// (208)
-"        "
-"  11111 "
-"  11 11 "
-"  11 11 "
-"  11 11 "
-"   111  "
-"        "
-"        ",
-
-// (209)
-"        "
-"  11 11 "
-"  11 11 "
-"  11 11 "
-"  11 11 "
-" 111111 "
-"        "
-"        ",
-
-// (210)
-"        "
-" 111111 "
-" 11  11 "
-" 111 11 "
-"     11 "
-" 111111 "
-"        "
-"        ",
-
-// (211)
-"        "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"    111 "
-" 111111 "
-"        "
-"        ",
-
-// (212)
-"        "
-"  11111 "
-"     11 "
-"  11 11 "
-"  11 11 "
-"  11 1  "
-"  11    "
-"        ",
-
-// (213)
-"        "
-" 1111   "
-"    11  "
-"    11  "
-"    11  "
-"    11  "
-"        "
-"        ",
-
-// (214)
-"        "
-"11 1 11 "
-"11 1 11 "
-"11 1 11 "
-"11 1 11 "
-"1111111 "
-"        "
-"        ",
-
-// (215)
-"        "
-" 11111  "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-"111 11  "
-"        "
-"        ",
-
-// (216)
-"        "
-"   111  "
-"    11  "
-"    11  "
-"    11  "
-"    11  "
-"    11  "
-"        ",
-
-// (217)
-"        "
-"  11111 "
-"     11 "
-"     11 "
-"     11 "
-"     11 "
-"     11 "
-"        ",
-
-// (218)
-"        "
-"1111111 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 111111 "
-"        "
-"        ",
-
-// (219)
-"        "
-" 111111 "
-" 11  11 "
-" 111 11 "
-"     11 "
-"     11 "
-"     11 "
-"        ",
-
-// (220)
-"        "
-"  11 11 "
-"  11 11 "
-"   111  "
-"    11  "
-"    11  "
-"    11  "
-"        ",
-
-// (221)
-"    111 "
-"   11 11"
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"11 11   "
-" 111    ",
-
-// (222)
-"        "
-"   1    "
-"  111   "
-" 11 11  "
-"11   11 "
-"1     1 "
-"        "
-"        ",
-
-// (223)
-" 11  11 "
-"1111 111"
-"1  11  1"
-"1  11  1"
-"111 1111"
-" 11  11 "
-"        "
-"        ",
-
-// (224)
-"        "
-"        "
-" 111 11 "
-"11 111  "
-"11  1   "
-"11 111  "
-" 111 11 "
-"        ",
-
-// (225)
-"   111  "
-"  11 11 "
-" 11  11 "
-" 11111  "
-" 11  11 "
-" 11  11 "
-" 11111  "
-" 11     ",
-
-// (226)
-"        "
-"1111111 "
-" 11  11 "
-" 11   1 "
-" 11     "
-" 11     "
-" 11     "
-"11111   ",
-
-// (227)
-"        "
-"        "
-"1111111 "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-" 1  1   ",
-
-// (228)
-"1111111 "
-" 11  11 "
-"  11    "
-"   11   "
-"  11    "
-" 11  11 "
-"1111111 "
-"        ",
-
-// (229)
-"        "
-"   1111 "
-"  111   "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-"  111   "
-"        ",
-
-// (230)
-"        "
-"        "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-" 1111111"
-"11      ",
-
-// (231)
-"        "
-"        "
-" 111111 "
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"   1    ",
-
-// (232)
-"  1111  "
-"   11   "
-"  1111  "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"   11   "
-"  1111  ",
-
-// (233)
-"        "
-"  1111  "
-" 11  11 "
-" 111111 "
-" 11  11 "
-" 11  11 "
-"  1111  "
-"        ",
-
-// (234)
-"        "
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"  1  1  "
-" 11  11 "
-"        ",
-
-// (235)
-"   111  "
-"  11 11 "
-" 1111   "
-"11 111  "
-"11  11  "
-"111 11  "
-" 1111   "
-"        ",
-
-// (236)
-"    11  "
-"   11   "
-"  111   "
-" 1 1 1  "
-" 1 1 1  "
-"  111   "
-"  11    "
-" 11     ",
-
-// (237)
-"        "
-"   1    "
-" 11111  "
-"11 1 11 "
-"11 1 11 "
-"11 1 11 "
-" 11111  "
-"   1    ",
-
-// (238)
-"  11111 "
-" 111    "
-" 11     "
-" 111111 "
-" 11     "
-" 111    "
-"  11111 "
-"        ",
-
-// (239)
-"  1111  "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-" 11  11 "
-"        ",
-
-// (240)
-"        "
-" 111111 "
-"        "
-" 111111 "
-"        "
-" 111111 "
-"        "
-"        ",
-
-// (241)
-"   11   "
-"   11   "
-" 111111 "
-"   11   "
-"   11   "
-"        "
-" 111111 "
-"        ",
-
-// (242)
-"  11    "
-"   11   "
-"    11  "
-"   11   "
-"  11    "
-"        "
-" 111111 "
-"        ",
-
-// (243)
-"    11  "
-"   11   "
-"  11    "
-"   11   "
-"    11  "
-"        "
-" 111111 "
-"        ",
-
-// (244)
-"        "
-"    111 "
-"   11 11"
-"   11 11"
-"   11   "
-"   11   "
-"   11   "
-"   11   ",
-
-// (245)
-"   11   "
-"   11   "
-"   11   "
-"   11   "
-"11 11   "
-"11 11   "
-" 111    "
-"        ",
-
-// (246)
-"   11   "
-"   11   "
-"        "
-" 111111 "
-"        "
-"   11   "
-"   11   "
-"        ",
-
-// (247)
-"        "
-"  11  1 "
-" 1  11  "
-"        "
-"  11  1 "
-" 1  11  "
-"        "
-"        ",
-
-// (248)
-"  111   "
-" 11 11  "
-"  111   "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// (249)
-"  111   "
-" 11111  "
-"  111   "
-"        "
-"        "
-"        "
-"        "
-"        ",
-
-// (250)
-"        "
-"        "
-"        "
-"        "
-"   11   "
-"   11   "
-"        "
-"        ",
+Font::Font() {
+    // All 256 glyphs packed 16 to a row into one white-on-transparent
+    // atlas, so a whole screen of text needs a single texture bind.
+    std::vector<uint8_t> pixels(AtlasSize * AtlasSize * 4, 0);
 
-// (251)
-"        "
-"        "
-"    1111"
-"   11   "
-"11 11   "
-" 111    "
-"  11    "
-"        ",
+    for (uint32_t c = 0; c < 256; c++) {
+        auto pixelbitmap = GlyphBitmap(c);
+        uint32_t left = (c % AtlasGlyphs) * GlyphSize;
+        uint32_t top = (c / AtlasGlyphs) * GlyphSize;
 
-// (252)
-"  111   "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-" 11 11  "
-"        "
-"        "
-"        ",
+        blank[c] = true;
 
-// (253)
-"  111   "
-" 11 11  "
-"   11   "
-"  11    "
-" 11111  "
-"        "
-"        "
-"        ",
+        for (uint32_t i = 0; i < GlyphSize * GlyphSize; i++) {
+            if (pixelbitmap[i] == ' ')
+                continue;
 
-// (254)
-" 1111   "
-"    11  "
-"  111   "
-"    11  "
-" 1111   "
-"        "
-"        "
-"        ",
+            blank[c] = false;
 
-// (255)
-"1111111 "
-"1111111 "
-"1111111 "
-"1111111 "
-"1111111 "
-"1111111 "
-"1111111 "
-"        "
+            size_t offset = ((top + i / GlyphSize) * AtlasSize + left + i % GlyphSize) * 4;
+            std::fill(pixels.begin() + offset, pixels.begin() + offset + 4, 255);
+        }
+    }
 
-};
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, AtlasSize, AtlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
 
-Font::Font() {
-    std::array<char, 256> nul{0};
-    for (int i = 0, z = 0; i < 64; i++, z+=4) {
-        auto pixel = nulpixelbitmap[i] != ' ' ? 255 : 0;
-        nul[z+0] = pixel;
-        nul[z+1] = pixel;
-        nul[z+2] = pixel;
-        nul[z+3] = pixel;
-    }
-    nulTexture = CreateTexture(nul);
+    // Room for a full 40x30 screen before the batch has to grow
+    batch.reserve(40 * 30 * 4);
+}
 
-    std::array<char, 256> block{0};
-    for (int i = 0, z = 0; i < 64; i++, z+=4) {
-        auto pixel = blockpixelbitmap[i] != ' ' ? 255 : 0;
-        block[z+0] = pixel;
-        block[z+1] = pixel;
-        block[z+2] = pixel;
-        block[z+3] = pixel;
-    }
+void Font::drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour) {
+    const GLfloat glyph = 1.0f / AtlasGlyphs;
 
-    blockTexture = CreateTexture(block); 
+    GLfloat left = x;
+    for (const auto c : str) {
+        uint8_t chr = (uint8_t)c;
 
-    for (uint32_t i = 0; i < fontTextures.size(); i++) {
-        std::array<char, 256> chr{0};
-        auto pixelbitmap = pixelbitmaps[i];
-        if (pixelbitmap) {
-            for (int i = 0, z = 0; i < 64; i++, z+=4) {
-                auto pixel = pixelbitmap[i] != ' ' ? 255 : 0;
-                chr[z+0] = pixel;
-                chr[z+1] = pixel;
-                chr[z+2] = pixel;
-                chr[z+3] = pixel;
-            }
+        if (!blank[chr]) {
+            GLfloat u = (chr % AtlasGlyphs) * glyph;
+            GLfloat v = (chr / AtlasGlyphs) * glyph;
 
-            fontTextures[i] = CreateTexture(chr);
-        } else {
-            fontTextures[i] = nulTexture;
+            batch.push_back({left, (GLfloat)y, u, v, colour.R(), colour.G(), colour.B(), colour.A()});
+            batch.push_back({left + w, (GLfloat)y, u + glyph, v, colour.R(), colour.G(), colour.B(), colour.A()});
+            batch.push_back({left + w, (GLfloat)(y + h), u + glyph, v + glyph, colour.R(), colour.G(), colour.B(), colour.A()});
+            batch.push_back({left, (GLfloat)(y + h), u, v + glyph, colour.R(), colour.G(), colour.B(), colour.A()});
         }
+
+        left += w;
     }
 }
 
-GLuint Font::CreateTexture(std::array<char, 256> pixels) {
-    GLuint texture;
+void Font::flush() {
+    if (batch.empty())
+        return;
 
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 8, 8, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
-
-    return texture;
-}
-
-void Font::drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str) {
     glEnable(GL_BLEND);
-
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    uint16_t offset = 0;
-
     glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, atlas);
 
-    for (const auto c : str) {
-        GLuint fontTexture = fontTextures[(uint8_t)c];
-        glBindTexture(GL_TEXTURE_2D, fontTexture);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
 
-        glBegin(GL_QUADS);
-            glTexCoord2f(0, 0);
-            glVertex2f(x + (offset*w), y);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &batch[0].x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &batch[0].u);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &batch[0].r);
 
-            glTexCoord2f(1, 0);
-            glVertex2f(x + (offset*w) + w, y);
+    glDrawArrays(GL_QUADS, 0, batch.size());
 
-            glTexCoord2f(1, 1);
-            glVertex2f(x + (offset*w) + w, y + h);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
 
-            glTexCoord2f(0, 1);
-            glVertex2f(x + (offset*w), y + h);
-        glEnd();
-        offset++;
-    }
     glDisable(GL_BLEND);
     glDisable(GL_TEXTURE_2D);
+
+    batch.clear();
 }
 
 Font::~Font() {
-    for (uint32_t i = 0; i < fontTextures.size(); i++) {
-        auto fontTexture = fontTextures[i];
-        glDeleteTextures(1, &fontTexture);
-    }
+    glDeleteTextures(1, &atlas);
 }
-
@@ -4,21 +4,39 @@
 #include <cstdint>
 #include <array>
 #include <string>
+#include <vector>
 
 #include "Common/Shared.h"
+#include "Common/Colour.h"
+#include "Renderer/Glyphs.h"
 
 namespace Renderer {
 //namespace Immediate {
 
 class Font {
-    GLuint nulTexture;
-    GLuint blockTexture;
-    std::array<GLuint, 256> fontTextures;
+    const static uint32_t AtlasGlyphs = 16;
+    const static uint32_t AtlasSize = GlyphSize * AtlasGlyphs;
 
-    static GLuint CreateTexture(std::array<char, 256> pixels);
+    struct Vertex {
+        GLfloat x, y;
+        GLfloat u, v;
+        GLubyte r, g, b, a;
+    };
+
+    GLuint atlas;
+    std::array<bool, 256> blank;
+
+    // Quads queued by drawString() until the next flush()
+    std::vector<Vertex> batch;
 public:
     Font();
-    void drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str);
+    void drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour);
+    void flush();
+
+    bool pending() const {
+        return !batch.empty();
+    }
+
     ~Font();
 };
 
@@ -1,32 +1,357 @@
 #include "Renderer/NCurses.h"
 
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
 #include <iostream>
 
 using namespace Renderer;
 
-NCurses::NCurses(std::shared_ptr<WINDOW> window) : window(window) {
+namespace {
+    const wchar_t UpperHalfBlock = 0x2580;
+
+    // Shown cells are reset to this to force every cell to be rewritten
+    const uint32_t Unknown = 0xFFFFFFFF;
+
+    // Brightness ramp for terminals without colour
+    const char ramp[] = " .:-=+*#%@";
+
+    uint32_t xterm256(uint32_t r, uint32_t g, uint32_t b) {
+        static const uint32_t levels[] = {0, 95, 135, 175, 215, 255};
+
+        auto level = [](uint32_t v) -> uint32_t {
+            return v < 48 ? 0 : v < 115 ? 1 : (v - 35) / 40;
+        };
+
+        auto distance = [r, g, b](uint32_t r2, uint32_t g2, uint32_t b2) {
+            int32_t dr = (int32_t)r - (int32_t)r2;
+            int32_t dg = (int32_t)g - (int32_t)g2;
+            int32_t db = (int32_t)b - (int32_t)b2;
+            return dr*dr + dg*dg + db*db;
+        };
+
+        uint32_t r6 = level(r);
+        uint32_t g6 = level(g);
+        uint32_t b6 = level(b);
+
+        uint32_t average = (r + g + b) / 3;
+        uint32_t grey = average < 8 ? 0 : std::min<uint32_t>((average - 8) / 10, 23);
+        uint32_t greyValue = 8 + grey * 10;
+
+        if (distance(greyValue, greyValue, greyValue) < distance(levels[r6], levels[g6], levels[b6]))
+            return 232 + grey;
+
+        return 16 + 36*r6 + 6*g6 + b6;
+    }
+};
+
+NCurses::NCurses(std::shared_ptr<WINDOW> window, uint32_t virtualWidth, uint32_t virtualHeight) : window(window), virtualWidth(virtualWidth), virtualHeight(virtualHeight), columns(0), rows(0), colours(0), maxPairs(0), halfBlocks(MB_CUR_MAX > 1), frames(0), cellsWritten(0) {
+    if (has_colors()) {
+        start_color();
+        colours = COLORS;
+        maxPairs = COLOR_PAIRS;
+
+#if !defined(NCURSES_EXT_COLORS)
+        // Direct colour needs the extended pair functions
+        colours = std::min(colours, 256);
+        maxPairs = std::min(maxPairs, 32767);
+#endif
+
+        if (colours < 8)
+            colours = 0;
+    }
+
+    resize();
+}
+
+void NCurses::resize() {
+    int32_t height;
+    int32_t width;
+
+    getmaxyx(window.get(), height, width);
+
+    // Leave room for the border drawn by Sys::NCurses
+    height = std::max(height - 2, 1);
+    width = std::max(width - 2, 1);
+
+    if (width == columns && height == rows)
+        return;
+
+    columns = width;
+    rows = height;
+
+    pixels.assign(columns * rows * 2, terminalColour(Common::Colour::Black.RGBA()));
+    text.assign(columns * rows, Cell{0, 0, 0});
+    shown.assign(columns * rows, Cell{0, Unknown, Unknown});
+}
+
+uint32_t NCurses::terminalColour(uint32_t rgba) const {
+    uint32_t r = (rgba >> 24) & 0xFF;
+    uint32_t g = (rgba >> 16) & 0xFF;
+    uint32_t b = (rgba >> 8) & 0xFF;
+
+    if (colours >= 0x1000000)
+        return (r << 16) | (g << 8) | b;
+
+    if (colours >= 256)
+        return xterm256(r, g, b);
+
+    if (colours >= 8)
+        return (r > 127 ? COLOR_RED : 0) | (g > 127 ? COLOR_GREEN : 0) | (b > 127 ? COLOR_BLUE : 0);
+
+    // No colour, keep the brightness for the ramp
+    return (r*77 + g*150 + b*29) >> 8;
+}
+
+int32_t NCurses::pair(uint32_t foreground, uint32_t background) {
+    if (!colours)
+        return 0;
+
+    uint64_t key = ((uint64_t)foreground << 32) | background;
+
+    auto found = pairs.find(key);
+    if (found != pairs.end())
+        return found->second;
+
+    // Out of pairs, flush() starts over on the next frame
+    int32_t next = pairs.size() + 1;
+    if (next >= maxPairs)
+        return 0;
+
+#if defined(NCURSES_EXT_COLORS)
+    init_extended_pair(next, foreground, background);
+#else
+    init_pair(next, foreground, background);
+#endif
+
+    pairs[key] = next;
+    return next;
+}
+
+int32_t NCurses::pixelX(double x) const {
+    return (int32_t)(x * columns / virtualWidth);
+}
+
+int32_t NCurses::pixelY(double y) const {
+    return (int32_t)(y * rows * 2 / virtualHeight);
+}
+
+void NCurses::fillPixels(int32_t left, int32_t top, int32_t right, int32_t bottom, uint32_t colour) {
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, columns);
+    bottom = std::min(bottom, rows * 2);
+
+    for (int32_t y = top; y < bottom; y++) {
+        for (int32_t x = left; x < right; x++)
+            pixels[y * columns + x] = colour;
+    }
 }
 
 void NCurses::drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour) {
-    mvwprintw(window.get(), (y/h)+1, (x/w)+1, str.c_str());
+    // Spread text over the window when it has room for every character,
+    // otherwise keep one cell per character and clip.
+    int32_t column = (int32_t)(virtualWidth / w) <= columns ? x * columns / virtualWidth : x / w;
+    int32_t row = (int32_t)(virtualHeight / h) <= rows ? y * rows / virtualHeight : y / h;
+
+    if (row < 0 || row >= rows)
+        return;
+
+    uint32_t foreground = terminalColour(colour.RGBA());
+
+    for (size_t i = 0; i < str.size() && column < columns; i++, column++) {
+        // Blank glyphs are transparent, as with the other renderers
+        if (column < 0 || str[i] == ' ')
+            continue;
+
+        text[row * columns + column] = Cell{(wchar_t)(uint8_t)str[i], foreground, 0};
+    }
 }
 
 void NCurses::drawRect(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const Common::Colour &colour) {
+    int32_t left = pixelX(x);
+    int32_t top = pixelY(y);
+
+    fillPixels(left, top, std::max(pixelX(x + w), left + 1), std::max(pixelY(y + h), top + 1), terminalColour(colour.RGBA()));
 }
 
 void NCurses::drawQuad(const Vec2d &a, const Vec2d &b, const Vec2d &c, const Vec2d &d, const Common::Colour &colour) {
+    const std::array<Vec2d, 4> corners = {
+        Vec2d(a.X() * columns / virtualWidth, a.Y() * rows * 2 / virtualHeight),
+        Vec2d(b.X() * columns / virtualWidth, b.Y() * rows * 2 / virtualHeight),
+        Vec2d(c.X() * columns / virtualWidth, c.Y() * rows * 2 / virtualHeight),
+        Vec2d(d.X() * columns / virtualWidth, d.Y() * rows * 2 / virtualHeight)
+    };
+    uint32_t fill = terminalColour(colour.RGBA());
+
+    double top = std::min({corners[0].Y(), corners[1].Y(), corners[2].Y(), corners[3].Y()});
+    double bottom = std::max({corners[0].Y(), corners[1].Y(), corners[2].Y(), corners[3].Y()});
+
+    // Scanline fill, sampling at pixel centres
+    for (int32_t y = std::max(0, (int32_t)top); y < std::min(rows * 2, (int32_t)bottom + 1); y++) {
+        double centre = y + 0.5;
+        double left = columns;
+        double right = -1.0;
+
+        for (size_t i = 0; i < corners.size(); i++) {
+            const Vec2d &p = corners[i];
+            const Vec2d &q = corners[(i + 1) % corners.size()];
+
+            if ((p.Y() <= centre && q.Y() > centre) || (q.Y() <= centre && p.Y() > centre)) {
+                double x = p.X() + (centre - p.Y()) * (q.X() - p.X()) / (q.Y() - p.Y());
+                left = std::min(left, x);
+                right = std::max(right, x);
+            }
+        }
+
+        if (right >= left)
+            fillPixels((int32_t)(left + 0.5), y, (int32_t)(right + 0.5), y + 1, fill);
+    }
 }
 
 void NCurses::drawLine(const Vec2d &start, const Vec2d &end, const Common::Colour &colour) {
+    uint32_t fill = terminalColour(colour.RGBA());
+
+    int32_t x0 = pixelX(start.X());
+    int32_t y0 = pixelY(start.Y());
+    int32_t x1 = pixelX(end.X());
+    int32_t y1 = pixelY(end.Y());
+
+    int32_t dx = std::abs(x1 - x0);
+    int32_t dy = -std::abs(y1 - y0);
+    int32_t sx = x0 < x1 ? 1 : -1;
+    int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t error = dx + dy;
+
+    while (true) {
+        fillPixels(x0, y0, x0 + 1, y0 + 1, fill);
+
+        if (x0 == x1 && y0 == y1)
+            break;
+
+        int32_t e2 = 2 * error;
+        if (e2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
 }
 
 void NCurses::drawPoint(const uint16_t x, const uint16_t y, const Common::Colour &colour, const uint16_t size) {
+    drawRect(x, y, size, size, colour);
 }
 
 void NCurses::drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t height, uint32_t size) {
+    // Each half cell averages the block of source pixels it covers, so
+    // thin lines fade rather than vanish when scaled down.
+    for (int32_t y = 0; y < rows * 2; y++) {
+        uint32_t y0 = y * height / (rows * 2);
+        uint32_t y1 = std::max((y + 1) * height / (rows * 2), y0 + 1);
+
+        for (int32_t x = 0; x < columns; x++) {
+            uint32_t x0 = x * width / columns;
+            uint32_t x1 = std::max((x + 1) * width / columns, x0 + 1);
+
+            uint32_t r = 0;
+            uint32_t g = 0;
+            uint32_t b = 0;
+
+            for (uint32_t sy = y0; sy < y1 && sy < height; sy++) {
+                const uint32_t *row = buffer + sy * width;
+
+                for (uint32_t sx = x0; sx < x1 && sx < width; sx++) {
+                    r += (row[sx] >> 24) & 0xFF;
+                    g += (row[sx] >> 16) & 0xFF;
+                    b += (row[sx] >> 8) & 0xFF;
+                }
+            }
+
+            uint32_t count = (std::min(y1, height) - y0) * (std::min(x1, width) - x0);
+            if (!count)
+                continue;
+
+            pixels[y * columns + x] = terminalColour(((r / count) << 24) | ((g / count) << 16) | ((b / count) << 8) | 0xFF);
+        }
+    }
 }
 
 void NCurses::drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t height, uint32_t size) {
+    std::vector<uint32_t> expanded(width * height);
+
+    for (size_t i = 0; i < expanded.size(); i++)
+        expanded[i] = Common::Colour::Colour8(buffer[i]).RGBA();
+
+    drawBuffer(expanded.data(), width, height, size);
+}
+
+void NCurses::flush() {
+    // Start over once the pair table is full, every cell is rewritten
+    // with the new pairs.
+    if (colours && (int32_t)pairs.size() + 1 >= maxPairs) {
+        pairs.clear();
+        std::fill(shown.begin(), shown.end(), Cell{0, Unknown, Unknown});
+    }
+
+    for (int32_t y = 0; y < rows; y++) {
+        for (int32_t x = 0; x < columns; x++) {
+            size_t index = y * columns + x;
+            uint32_t top = pixels[(y * 2) * columns + x];
+            uint32_t bottom = pixels[(y * 2 + 1) * columns + x];
+            const Cell &overlay = text[index];
+            Cell cell;
+
+            if (overlay.character) {
+                cell = Cell{overlay.character, overlay.foreground, top};
+            } else if (!colours) {
+                cell = Cell{(wchar_t)ramp[((top + bottom) / 2) * (sizeof(ramp) - 1) / 256], 0, 0};
+            } else if (top == bottom || !halfBlocks) {
+                cell = Cell{L' ', top, top};
+            } else {
+                cell = Cell{UpperHalfBlock, top, bottom};
+            }
+
+            if (cell == shown[index])
+                continue;
+
+            int32_t colourPair = colours ? pair(cell.foreground, cell.background) : 0;
+            wchar_t characters[2] = {cell.character, 0};
+            cchar_t c;
+
+#if defined(NCURSES_EXT_COLORS)
+            setcchar(&c, characters, A_NORMAL, 0, &colourPair);
+#else
+            setcchar(&c, characters, A_NORMAL, (short)colourPair, nullptr);
+#endif
+
+            mvwadd_wch(window.get(), y + 1, x + 1, &c);
+
+            shown[index] = cell;
+            cellsWritten++;
+        }
+    }
+
+    frames++;
+
+    // Every frame is drawn from scratch, only the output is diffed
+    std::fill(pixels.begin(), pixels.end(), terminalColour(Common::Colour::Black.RGBA()));
+    std::fill(text.begin(), text.end(), Cell{0, 0, 0});
+
+    resize();
+}
+
+std::string NCurses::report() const {
+    std::ostringstream s;
+
+    s << std::fixed << std::setprecision(1);
+    s << "Terminal: " << columns << "x" << rows << " cells, " << (colours >= 0x1000000 ? std::string("direct") : std::to_string(colours)) << " colours, ";
+    s << frames << " frames, " << (frames ? (double)cellsWritten / frames : 0.0) << " cells written per frame, " << pairs.size() << " colour pairs";
+
+    return s.str();
 }
 
 void NCurses::changeDisplayMode(const Common::DisplayMode &displayMode) {
@@ -5,7 +5,12 @@
 #include <array>
 #include <string>
 #include <memory>
+#include <vector>
+#include <map>
 
+#ifndef NCURSES_WIDECHAR
+#define NCURSES_WIDECHAR 1
+#endif
 #include <ncurses.h>
 
 #include "Common/DisplayMode.h"
@@ -13,10 +18,58 @@
 
 namespace Renderer {
 
+// Draws into the window interior with one half block per two pixels, so
+// each cell holds a top and bottom pixel as its foreground and background.
+// Frames are composed in memory and flush() only writes the cells that
+// differ from what the terminal already shows.
 class NCurses : public Base {
+    struct Cell {
+        wchar_t character;
+        uint32_t foreground;
+        uint32_t background;
+
+        bool operator==(const Cell &other) const {
+            return character == other.character && foreground == other.foreground && background == other.background;
+        }
+
+        bool operator!=(const Cell &other) const {
+            return !(*this == other);
+        }
+    };
+
     std::shared_ptr<WINDOW> window;
+
+    const uint32_t virtualWidth;
+    const uint32_t virtualHeight;
+
+    int32_t columns;
+    int32_t rows;
+
+    // Terminal colour for each half-cell pixel, two rows per cell row
+    std::vector<uint32_t> pixels;
+    std::vector<Cell> text;
+    std::vector<Cell> shown;
+
+    // Colours are terminal colour numbers, direct RGB when the terminal
+    // has 2^24 of them. Pairs are allocated as colour combinations turn up.
+    int32_t colours;
+    int32_t maxPairs;
+
+    // Half blocks need a UTF-8 locale, otherwise cells show the top pixel
+    bool halfBlocks;
+    std::map<uint64_t, int32_t> pairs;
+
+    uint64_t frames;
+    uint64_t cellsWritten;
+
+    void resize();
+    uint32_t terminalColour(uint32_t rgba) const;
+    int32_t pair(uint32_t foreground, uint32_t background);
+    void fillPixels(int32_t left, int32_t top, int32_t right, int32_t bottom, uint32_t colour);
+    int32_t pixelX(double x) const;
+    int32_t pixelY(double y) const;
 public:
-    NCurses(std::shared_ptr<WINDOW> window);
+    NCurses(std::shared_ptr<WINDOW> window, uint32_t virtualWidth=320, uint32_t virtualHeight=240);
     void drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour = Common::Colour::White);
     void drawRect(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const Common::Colour &colour);
     void drawQuad(const Vec2d &a, const Vec2d &b, const Vec2d &c, const Vec2d &d, const Common::Colour &colour);
@@ -29,10 +82,12 @@ public:
 
     void changeDisplayMode(const Common::DisplayMode &displayMode);
 
+    void flush();
+    std::string report() const;
+
     ~NCurses();
 };
 
 }; // namespace Renderer
 
 #endif //__RENDERER_NCURSES_H__
-
@@ -0,0 +1,360 @@
+#include "Renderer/Software.h"
+#include "Renderer/Glyphs.h"
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace Renderer;
+
+// Writes each of width source pixels scale times into dst.
+static void scaleRow(const uint32_t *src, uint32_t *dst, uint32_t width, uint32_t scale) {
+    uint32_t i = 0;
+
+    if (scale == 1) {
+        std::memcpy(dst, src, width * sizeof(uint32_t));
+        return;
+    }
+
+#if defined(__SSE2__)
+    if (scale == 2) {
+        for (; i + 4 <= width; i += 4) {
+            __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i));
+
+            _mm_storeu_si128((__m128i *)(dst + i*2), _mm_unpacklo_epi32(pixels, pixels));
+            _mm_storeu_si128((__m128i *)(dst + i*2 + 4), _mm_unpackhi_epi32(pixels, pixels));
+        }
+    } else if (scale == 4) {
+        for (; i + 4 <= width; i += 4) {
+            __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i));
+
+            _mm_storeu_si128((__m128i *)(dst + i*4), _mm_shuffle_epi32(pixels, 0x00));
+            _mm_storeu_si128((__m128i *)(dst + i*4 + 4), _mm_shuffle_epi32(pixels, 0x55));
+            _mm_storeu_si128((__m128i *)(dst + i*4 + 8), _mm_shuffle_epi32(pixels, 0xAA));
+            _mm_storeu_si128((__m128i *)(dst + i*4 + 12), _mm_shuffle_epi32(pixels, 0xFF));
+        }
+    } else {
+        for (; i < width; i++) {
+            __m128i pixel = _mm_set1_epi32(src[i]);
+            uint32_t *out = dst + i*scale;
+            uint32_t n = 0;
+
+            for (; n + 4 <= scale; n += 4)
+                _mm_storeu_si128((__m128i *)(out + n), pixel);
+
+            for (; n < scale; n++)
+                out[n] = src[i];
+        }
+    }
+#endif
+
+    for (; i < width; i++)
+        std::fill_n(dst + i*scale, scale, src[i]);
+}
+
+static void writeBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc=0) {
+    static uint32_t table[256] = {0};
+
+    if (!table[1]) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static void writeChunk(std::ofstream &file, const char *type, const std::vector<uint8_t> &data) {
+    std::vector<uint8_t> chunk;
+
+    writeBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    writeBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+
+    file.write((const char *)chunk.data(), chunk.size());
+}
+
+Software::Software(uint32_t virtualWidth, uint32_t virtualHeight, uint32_t scale) : virtualWidth(virtualWidth), virtualHeight(virtualHeight), scale(scale ? scale : 1) {
+    image.resize(Width() * Height());
+    clear();
+}
+
+void Software::clear(const Common::Colour &colour) {
+    std::fill(image.begin(), image.end(), colour.RGBA());
+}
+
+void Software::fillRect(int32_t left, int32_t top, int32_t right, int32_t bottom, uint32_t rgba) {
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, (int32_t)Width());
+    bottom = std::min(bottom, (int32_t)Height());
+
+    for (int32_t y = top; y < bottom; y++)
+        std::fill(image.begin() + y*Width() + left, image.begin() + y*Width() + std::max(left, right), rgba);
+}
+
+void Software::plot(int32_t x, int32_t y, uint32_t rgba) {
+    fillRect(x*scale, y*scale, (x+1)*scale, (y+1)*scale, rgba);
+}
+
+void Software::drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour) {
+    uint32_t rgba = colour.RGBA();
+    int32_t left = x * scale;
+    int32_t top = y * scale;
+    int32_t width = w * scale;
+    int32_t height = h * scale;
+
+    for (const auto c : str) {
+        const char *glyph = GlyphBitmap((uint8_t)c);
+
+        for (uint32_t row = 0; row < GlyphSize; row++) {
+            int32_t y0 = top + row * height / GlyphSize;
+            int32_t y1 = top + (row + 1) * height / GlyphSize;
+
+            for (uint32_t column = 0; column < GlyphSize; column++) {
+                if (glyph[row*GlyphSize + column] == ' ')
+                    continue;
+
+                fillRect(left + column * width / GlyphSize, y0, left + (column + 1) * width / GlyphSize, y1, rgba);
+            }
+        }
+
+        left += width;
+    }
+}
+
+void Software::drawRect(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const Common::Colour &colour) {
+    fillRect(x*scale, y*scale, (x + w)*scale, (y + h)*scale, colour.RGBA());
+}
+
+void Software::drawQuad(const Vec2d &a, const Vec2d &b, const Vec2d &c, const Vec2d &d, const Common::Colour &colour) {
+    const std::array<Vec2d, 4> corners = {a, b, c, d};
+    uint32_t rgba = colour.RGBA();
+
+    double top = std::min({a.Y(), b.Y(), c.Y(), d.Y()});
+    double bottom = std::max({a.Y(), b.Y(), c.Y(), d.Y()});
+
+    // Scanline fill, sampling at pixel centres
+    for (int32_t y = std::max(0, (int32_t)top); y < std::min((int32_t)virtualHeight, (int32_t)bottom + 1); y++) {
+        double centre = y + 0.5;
+        double left = virtualWidth;
+        double right = -1.0;
+
+        for (size_t i = 0; i < corners.size(); i++) {
+            const Vec2d &p = corners[i];
+            const Vec2d &q = corners[(i + 1) % corners.size()];
+
+            if ((p.Y() <= centre && q.Y() > centre) || (q.Y() <= centre && p.Y() > centre)) {
+                double x = p.X() + (centre - p.Y()) * (q.X() - p.X()) / (q.Y() - p.Y());
+                left = std::min(left, x);
+                right = std::max(right, x);
+            }
+        }
+
+        if (right >= left)
+            fillRect((int32_t)(left + 0.5) * scale, y * scale, (int32_t)(right + 0.5) * scale, (y + 1) * scale, rgba);
+    }
+}
+
+void Software::drawPoint(const uint16_t x, const uint16_t y, const Common::Colour &colour, const uint16_t size) {
+    fillRect(x*scale, y*scale, (x + size)*scale, (y + size)*scale, colour.RGBA());
+}
+
+void Software::drawLine(const Vec2d &start, const Vec2d &end, const Common::Colour &colour) {
+    uint32_t rgba = colour.RGBA();
+
+    int32_t x0 = (int32_t)start.X();
+    int32_t y0 = (int32_t)start.Y();
+    int32_t x1 = (int32_t)end.X();
+    int32_t y1 = (int32_t)end.Y();
+
+    int32_t dx = std::abs(x1 - x0);
+    int32_t dy = -std::abs(y1 - y0);
+    int32_t sx = x0 < x1 ? 1 : -1;
+    int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t error = dx + dy;
+
+    while (true) {
+        plot(x0, y0, rgba);
+
+        if (x0 == x1 && y0 == y1)
+            break;
+
+        int32_t e2 = 2 * error;
+        if (e2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void Software::drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t height, uint32_t size) {
+    uint32_t factor = scale * size;
+    uint32_t columns = std::min(width, Width() / factor);
+    uint32_t rows = std::min(height, Height() / factor);
+
+    for (uint32_t y = 0; y < rows; y++) {
+        uint32_t *row = image.data() + (y * factor) * Width();
+
+        scaleRow(buffer + y * width, row, columns, factor);
+
+        for (uint32_t copy = 1; copy < factor; copy++)
+            std::memcpy(row + copy * Width(), row, columns * factor * sizeof(uint32_t));
+    }
+}
+
+void Software::drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t height, uint32_t size) {
+    static std::array<uint32_t, 256> rgb332;
+
+    if (!rgb332[0]) {
+        for (size_t i = 0; i < rgb332.size(); i++)
+            rgb332[i] = Common::Colour::Colour8(i).RGBA();
+    }
+
+    std::vector<uint32_t> expanded(width * height);
+    std::transform(buffer, buffer + expanded.size(), expanded.begin(),
+        [](uint8_t pixel) {
+            return rgb332[pixel];
+        }
+    );
+
+    drawBuffer(expanded.data(), width, height, size);
+}
+
+bool Software::translatePoint(Point &screen, const Point &real) {
+    if (real.X() < 0 || real.Y() < 0 || real.X() >= (int32_t)Width() || real.Y() >= (int32_t)Height())
+        return false;
+
+    screen = Point(real.X() / scale, real.Y() / scale);
+
+    return true;
+}
+
+void Software::changeDisplayMode(const Common::DisplayMode &displayMode) {
+}
+
+uint64_t Software::Hash() const {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    // Bytes in R, G, B, A order whatever the host byte order
+    for (auto pixel : image) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            hash ^= (pixel >> shift) & 0xFF;
+            hash *= 0x100000001B3ULL;
+        }
+    }
+
+    return hash;
+}
+
+bool Software::savePPM(const std::string &filename) const {
+    std::ofstream file(filename, std::ios_base::binary);
+
+    if (!file.is_open())
+        return false;
+
+    file << "P6\n" << Width() << " " << Height() << "\n255\n";
+
+    std::vector<uint8_t> rgb;
+    rgb.reserve(image.size() * 3);
+
+    for (auto pixel : image) {
+        rgb.push_back(pixel >> 24);
+        rgb.push_back(pixel >> 16);
+        rgb.push_back(pixel >> 8);
+    }
+
+    file.write((const char *)rgb.data(), rgb.size());
+
+    return file.good();
+}
+
+bool Software::savePNG(const std::string &filename) const {
+    std::ofstream file(filename, std::ios_base::binary);
+
+    if (!file.is_open())
+        return false;
+
+    const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write((const char *)signature, sizeof(signature));
+
+    std::vector<uint8_t> header;
+    writeBigEndian(header, Width());
+    writeBigEndian(header, Height());
+    header.push_back(8);    // bit depth
+    header.push_back(6);    // RGBA
+    header.push_back(0);    // deflate
+    header.push_back(0);    // adaptive filtering
+    header.push_back(0);    // no interlace
+    writeChunk(file, "IHDR", header);
+
+    // Raw scanlines, each prefixed with filter type 0
+    std::vector<uint8_t> raw;
+    raw.reserve(Height() * (Width() * 4 + 1));
+
+    for (uint32_t y = 0; y < Height(); y++) {
+        raw.push_back(0);
+        for (uint32_t x = 0; x < Width(); x++)
+            writeBigEndian(raw, image[y * Width() + x]);
+    }
+
+    // zlib stream made of stored deflate blocks, which keeps this free
+    // of a compression library at the cost of file size.
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    uint32_t a = 1;
+    uint32_t b = 0;
+
+    for (size_t offset = 0; offset < raw.size() || offset == 0;) {
+        uint16_t length = (uint16_t)std::min(raw.size() - offset, (size_t)0xFFFF);
+        bool last = offset + length == raw.size();
+
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(length & 0xFF);
+        zlib.push_back(length >> 8);
+        zlib.push_back(~length & 0xFF);
+        zlib.push_back((~length >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+
+        for (size_t i = offset; i < offset + length; i++) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+
+        offset += length;
+        if (last)
+            break;
+    }
+
+    writeBigEndian(zlib, (b << 16) | a);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", {});
+
+    return file.good();
+}
+
+Software::~Software() {
+}
@@ -0,0 +1,65 @@
+#ifndef __RENDERER_SOFTWARE_H__
+#define __RENDERER_SOFTWARE_H__
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Common/DisplayMode.h"
+#include "Renderer/Base.h"
+
+namespace Renderer {
+
+// Composes frames into an RGBA image in memory, packed the same way as
+// Common::Colour::RGBA(). Needs no GL context, so works headless.
+class Software : public Base {
+    const uint32_t virtualWidth;
+    const uint32_t virtualHeight;
+    const uint32_t scale;
+
+    std::vector<uint32_t> image;
+
+    void fillRect(int32_t left, int32_t top, int32_t right, int32_t bottom, uint32_t rgba);
+    void plot(int32_t x, int32_t y, uint32_t rgba);
+public:
+    Software(uint32_t virtualWidth=320, uint32_t virtualHeight=240, uint32_t scale=1);
+
+    void drawString(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const std::string &str, const Common::Colour &colour = Common::Colour::White);
+    void drawRect(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h, const Common::Colour &colour);
+    void drawQuad(const Vec2d &a, const Vec2d &b, const Vec2d &c, const Vec2d &d, const Common::Colour &colour);
+    void drawPoint(const uint16_t x, const uint16_t y, const Common::Colour &colour, const uint16_t size=1);
+    void drawLine(const Vec2d &start, const Vec2d &end, const Common::Colour &colour);
+    void drawBuffer(const uint32_t *buffer, uint32_t width, uint32_t height, uint32_t size=1);
+    void drawBuffer(const uint8_t *buffer, uint32_t width, uint32_t height, uint32_t size=1);
+
+    bool translatePoint(Point &screen, const Point &real);
+
+    void changeDisplayMode(const Common::DisplayMode &displayMode);
+
+    void clear(const Common::Colour &colour = Common::Colour::Black);
+
+    uint32_t Width() const {
+        return virtualWidth * scale;
+    }
+
+    uint32_t Height() const {
+        return virtualHeight * scale;
+    }
+
+    const uint32_t *Pixels() const {
+        return image.data();
+    }
+
+    // FNV-1a over the image, stable across runs and platforms
+    uint64_t Hash() const;
+
+    bool savePPM(const std::string &filename) const;
+    bool savePNG(const std::string &filename) const;
+
+    ~Software();
+};
+
+}; // namespace Renderer
+
+#endif //__RENDERER_SOFTWARE_H__
@@ -5,9 +5,12 @@
 #include <vector>
 #include <utility>
 #include <memory>
+#include <string>
 
 #include "Common/Shared.h"
 #include "Common/DisplayMode.h"
+#include "Audio/Sequence.h"
+#include "Audio/Sample.h"
 
 namespace Client {
     class State;
@@ -29,7 +32,19 @@ namespace Sys {
             virtual void swapBuffers() = 0;
             virtual bool handleEvents(std::shared_ptr<Client::State> clientState) = 0;
             virtual void keyRepeat(bool enable) = 0;
-            virtual void sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) = 0;
+            // time is the emulated milliseconds of the frame issuing the
+            // sound, pan runs from 0 (left) to 255 (right)
+            virtual void sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) = 0;
+            // A whole tune on the voice, starting delay samples after time
+            virtual void play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) = 0;
+            // A sample on the voice at rate samples a second
+            virtual void pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan) = 0;
+
+            // System specific statistics for --stats, empty if there are none
+            virtual std::string report() const {
+                return std::string();
+            }
+
             virtual ~Base() {}
     };
 }; // Sys
@@ -371,28 +371,27 @@ void Sys::GLFW::keyRepeat(bool enable) {
     RepeatKeys = enable;
 }
 
-void Sys::GLFW::sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
-    voices[voice].tone(frequency, duration, waveForm, volume, attack, decay, sustain, release);
+void Sys::GLFW::sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.sound(time, voice, frequency, duration, waveForm, volume, attack, decay, sustain, release, pan);
 }
 
-static int tonecallback(const void *inputBuffer, void *outputBuffer, unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData) {
-    Audio::Tone *voices = (Audio::Tone *)userData;
+void Sys::GLFW::play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.play(time, voice, sequence, delay, waveForm, volume, attack, decay, sustain, release, pan);
+}
 
-    float *out = (float *)outputBuffer;
-    std::vector<float> buffer;
-    buffer.resize(framesPerBuffer, 0.0f);
+void Sys::GLFW::pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan) {
+    mixer.pcm(time, voice, sample, rate, volume, pan);
+}
 
-    voices[0].generateSamples(buffer.data(), framesPerBuffer, 0.25);
-    voices[1].generateSamples(buffer.data(), framesPerBuffer, 0.25);
-    voices[2].generateSamples(buffer.data(), framesPerBuffer, 0.25);
-    voices[3].generateSamples(buffer.data(), framesPerBuffer, 0.25);
+static int tonecallback(const void *inputBuffer, void *outputBuffer, unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData) {
+    Audio::Mixer *mixer = (Audio::Mixer *)userData;
 
-    std::memcpy(out, buffer.data(), sizeof(float) * framesPerBuffer);
+    mixer->mix((float *)outputBuffer, framesPerBuffer);
 
     return 0;
 }
 
-Sys::GLFW::GLFW(const std::string &title) {
+Sys::GLFW::GLFW(const std::string &title, uint32_t period, size_t voices) : mixer(period ? period : 256, voices) {
     if (!glfwInit())
         exit(EXIT_FAILURE);
 
@@ -403,9 +402,6 @@ Sys::GLFW::GLFW(const std::string &title) {
 
     auto mode = getDisplayModes().front();
 
-    for (int i = 0; i < VOICE_COUNT; i++)
-        voices[i] = Audio::Tone();
-
     window = std::shared_ptr<GLFWwindow>(
         glfwCreateWindow(mode.Width(), mode.Height(), (std::string("GLFW ") + title).c_str(), NULL, NULL),
         glfwDestroyWindow
@@ -421,16 +417,21 @@ Sys::GLFW::GLFW(const std::string &title) {
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    if (Pa_Initialize() == paNoError && Pa_OpenDefaultStream(
-        &stream,
-        0,          // no input channels
-        1,          // mono output
-        paFloat32,
-        Audio::FREQUENCY,
-        256,        // frames per buffer
-        tonecallback,
-        voices.data()
-    ) == paNoError && Pa_StartStream(stream) == paNoError);
+    // Ask for as little buffering as the period allows, the default
+    // stream uses the device's high latency setting.
+    PaStreamParameters output;
+
+    if (Pa_Initialize() == paNoError && (output.device = Pa_GetDefaultOutputDevice()) != paNoDevice) {
+        output.channelCount = 2;
+        output.sampleFormat = paFloat32;
+        output.suggestedLatency = (double)mixer.Period() / Audio::FREQUENCY;
+        output.hostApiSpecificStreamInfo = NULL;
+
+        if (Pa_OpenStream(&stream, NULL, &output, Audio::FREQUENCY, mixer.Period(), paNoFlag, tonecallback, &mixer) == paNoError && Pa_StartStream(stream) == paNoError) {
+            if (const PaStreamInfo *info = Pa_GetStreamInfo(stream))
+                mixer.setOutputLatency(info->outputLatency);
+        }
+    }
 }
 
 Sys::GLFW::~GLFW() {
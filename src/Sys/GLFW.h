@@ -13,15 +13,15 @@
 #include "Sys/Base.h"
 #include "Client/State.h"
 
-#include "Audio/Tone.h"
+#include "Audio/Mixer.h"
 
 namespace Sys {
     class GLFW : public Base {
             std::shared_ptr<GLFWwindow> window;
             PaStream *stream;
-            std::array<Audio::Tone, VOICE_COUNT> voices;
+            Audio::Mixer mixer;
         public:
-            GLFW(const std::string &title);
+            GLFW(const std::string &title, uint32_t period=0, size_t voices=Audio::DEFAULT_VOICES);
             ~GLFW();
             Common::DisplayMode changeDisplayMode(const Common::DisplayMode &displayMode, bool fullscreen);
             std::vector<Common::DisplayMode> getDisplayModes() const;
@@ -45,7 +45,13 @@ namespace Sys {
 
             void keyRepeat(bool enable);
 
-            void sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release);
+            std::string report() const {
+                return mixer.report();
+            }
+
+            void sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan);
     };
 }; // Sys
 
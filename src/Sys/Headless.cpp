@@ -0,0 +1,337 @@
+#include "Sys/Headless.h"
+#include "Common/Keys.h"
+#include "Common/FramePacer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+
+namespace {
+    struct KeyMapping {
+        char plain;
+        char shifted;
+        uint32_t keyCode;
+    };
+
+    const KeyMapping symbols[] = {
+        {'1', '!', Common::Keys::Num1},
+        {'2', '@', Common::Keys::Num2},
+        {'3', '#', Common::Keys::Num3},
+        {'4', '$', Common::Keys::Num4},
+        {'5', '%', Common::Keys::Num5},
+        {'6', '^', Common::Keys::Num6},
+        {'7', '&', Common::Keys::Num7},
+        {'8', '*', Common::Keys::Num8},
+        {'9', '(', Common::Keys::Num9},
+        {'0', ')', Common::Keys::Num0},
+        {'`', '~', Common::Keys::Backquote},
+        {'[', '{', Common::Keys::LBracket},
+        {']', '}', Common::Keys::RBracket},
+        {';', ':', Common::Keys::Semicolon},
+        {',', '<', Common::Keys::Comma},
+        {'.', '>', Common::Keys::Period},
+        {'\'', '"', Common::Keys::Quote},
+        {'/', '?', Common::Keys::Slash},
+        {'\\', '|', Common::Keys::Backslash},
+        {'=', '+', Common::Keys::Equal},
+        {'-', '_', Common::Keys::Hyphen},
+        {' ', 0, Common::Keys::Space},
+        {'\t', 0, Common::Keys::Tab},
+    };
+
+    const std::map<std::string, uint32_t> named = {
+        {"enter", Common::Keys::Enter},
+        {"escape", Common::Keys::Escape},
+        {"backspace", Common::Keys::Backspace},
+        {"tab", Common::Keys::Tab},
+        {"space", Common::Keys::Space},
+        {"up", Common::Keys::Up},
+        {"down", Common::Keys::Down},
+        {"left", Common::Keys::Left},
+        {"right", Common::Keys::Right},
+        {"home", Common::Keys::Home},
+        {"end", Common::Keys::End},
+        {"pageup", Common::Keys::PageUp},
+        {"pagedown", Common::Keys::PageDown},
+        {"insert", Common::Keys::Insert},
+        {"delete", Common::Keys::Delete},
+        {"f1", Common::Keys::F1},
+        {"f2", Common::Keys::F2},
+        {"f3", Common::Keys::F3},
+        {"f4", Common::Keys::F4},
+        {"f5", Common::Keys::F5},
+        {"f6", Common::Keys::F6},
+        {"f7", Common::Keys::F7},
+        {"f8", Common::Keys::F8},
+        {"f9", Common::Keys::F9},
+        {"f10", Common::Keys::F10},
+        {"f11", Common::Keys::F11},
+        {"f12", Common::Keys::F12},
+    };
+
+    bool toKeyPress(char c, Client::KeyPress &key) {
+        key = Client::KeyPress();
+
+        if (c >= 'a' && c <= 'z') {
+            key.keyCode = Common::Keys::A + (c - 'a');
+            return true;
+        }
+
+        if (c >= 'A' && c <= 'Z') {
+            key.keyCode = Common::Keys::A + (c - 'A');
+            key.shiftMod = true;
+            return true;
+        }
+
+        for (const auto &symbol : symbols) {
+            if (c == symbol.plain || (symbol.shifted && c == symbol.shifted)) {
+                key.keyCode = symbol.keyCode;
+                key.shiftMod = c == symbol.shifted;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool toKeyPress(const std::string &name, Client::KeyPress &key) {
+        if (name.size() == 1)
+            return toKeyPress(name[0], key);
+
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+        auto found = named.find(lower);
+        if (found == named.end())
+            return false;
+
+        key = Client::KeyPress();
+        key.keyCode = found->second;
+        return true;
+    }
+};
+
+Sys::Headless::Headless(const std::string &script, uint64_t frames, double rate, size_t voices) : rate(rate), frames(frames), frame(0), next(0), mixer(0, voices), mix(1024 * 2), pcm16(mix.size()), samples(0), audioEnd(0), audioHash(0xcbf29ce484222325ULL), audioTime(0) {
+    mixer.seed(1);
+
+    if (!script.empty())
+        load(script);
+}
+
+Sys::Headless::~Headless() {
+}
+
+void Sys::Headless::load(const std::string &filename) {
+    std::ifstream file(filename);
+
+    if (!file.is_open()) {
+        std::cerr << "Could not open `" << filename << "'" << std::endl;
+        exit(-1);
+    }
+
+    std::string line;
+    size_t number = 0;
+
+    while (std::getline(file, line)) {
+        number++;
+
+        std::istringstream in(line);
+        std::string command;
+        Event event;
+
+        if (!(in >> event.frame >> command)) {
+            auto first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+                continue;
+
+            std::cerr << filename << ":" << number << ": expected a frame and an event" << std::endl;
+            exit(-1);
+        }
+
+        bool valid = true;
+
+        if (command == "type") {
+            std::string text;
+            std::getline(in >> std::ws, text);
+
+            for (char c : text) {
+                if (c == '\r')
+                    continue;
+
+                valid = valid && toKeyPress(c, event.key);
+
+                event.type = Event::Type::KeyDown;
+                script.push_back(event);
+                event.type = Event::Type::KeyUp;
+                script.push_back(event);
+            }
+        } else if (command == "key" || command == "down" || command == "up") {
+            std::string name;
+            valid = (in >> name) && toKeyPress(name, event.key);
+
+            if (command != "up") {
+                event.type = Event::Type::KeyDown;
+                script.push_back(event);
+            }
+
+            if (command != "down") {
+                event.type = Event::Type::KeyUp;
+                script.push_back(event);
+            }
+        } else if (command == "move") {
+            event.type = Event::Type::MouseMove;
+            event.move = Client::MouseMove();
+            valid = (bool)(in >> event.move.x >> event.move.y);
+            script.push_back(event);
+        } else if (command == "press" || command == "release") {
+            std::string button;
+            event.type = command == "press" ? Event::Type::MouseDown : Event::Type::MouseUp;
+            event.click = Client::MouseClick();
+            valid = (bool)(in >> button >> event.click.x >> event.click.y);
+            event.click.leftPressed = button == "left";
+            event.click.middlePressed = button == "middle";
+            event.click.rightPressed = button == "right";
+            valid = valid && (event.click.leftPressed || event.click.middlePressed || event.click.rightPressed);
+            script.push_back(event);
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << filename << ":" << number << ": invalid event `" << line << "'" << std::endl;
+            exit(-1);
+        }
+    }
+
+    // Events on the same frame keep the order they were written in
+    std::stable_sort(script.begin(), script.end(), [](const Event &a, const Event &b) {
+        return a.frame < b.frame;
+    });
+}
+
+Common::DisplayMode Sys::Headless::changeDisplayMode(const Common::DisplayMode &displayMode, bool fullscreen) {
+    return currentDisplayMode();
+}
+
+std::vector<Common::DisplayMode> Sys::Headless::getDisplayModes() const {
+    std::vector<Common::DisplayMode> modes;
+    modes.push_back(currentDisplayMode());
+    return modes;
+}
+
+Common::DisplayMode Sys::Headless::findDisplayMode(uint16_t width, uint16_t height) const {
+    return currentDisplayMode();
+}
+
+Common::DisplayMode Sys::Headless::currentDisplayMode() const {
+    return Common::DisplayMode(320, 240, (uint16_t)rate);
+}
+
+std::pair<Common::DisplayMode, Common::DisplayMode> Sys::Headless::getPreviousNextMode(const Common::DisplayMode &displayMode) const {
+    return std::pair<Common::DisplayMode, Common::DisplayMode>(currentDisplayMode(), currentDisplayMode());
+}
+
+uint32_t Sys::Headless::getTicks() const {
+    return (uint32_t)((double)frame * 1000.0 / rate);
+}
+
+uint64_t Sys::Headless::frameSample() const {
+    return (uint64_t)((double)frame * Audio::FREQUENCY / rate);
+}
+
+bool Sys::Headless::handleEvents(std::shared_ptr<Client::State> clientState) {
+    // Notes from the last frame start exactly on this frame's first sample
+    renderAudio(frameSample());
+
+    if (frames && frame >= frames)
+        return false;
+
+    while (next < script.size() && script[next].frame <= frame) {
+        const Event &event = script[next++];
+
+        switch (event.type) {
+            case Event::Type::KeyDown:
+                clientState->keyDown(event.key);
+                break;
+            case Event::Type::KeyUp:
+                clientState->keyUp(event.key);
+                break;
+            case Event::Type::MouseMove:
+                clientState->mouseMove(event.move);
+                break;
+            case Event::Type::MouseDown:
+                clientState->mouseButtonPress(event.click);
+                break;
+            case Event::Type::MouseUp:
+                clientState->mouseButtonRelease(event.click);
+                break;
+        }
+    }
+
+    frame++;
+
+    return true;
+}
+
+void Sys::Headless::sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.sound(time, voice, frequency, duration, waveForm, volume, attack, decay, sustain, release, pan);
+    audioEnd = std::max(audioEnd, ((uint64_t)time + duration) * Audio::FREQUENCY / 1000);
+}
+
+void Sys::Headless::play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.play(time, voice, sequence, delay, waveForm, volume, attack, decay, sustain, release, pan);
+    audioEnd = std::max(audioEnd, (uint64_t)time * Audio::FREQUENCY / 1000 + delay + sequence->Length());
+}
+
+void Sys::Headless::pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan) {
+    mixer.pcm(time, voice, sample, rate, volume, pan);
+
+    if (!sample->Looped() && rate > 0.0f)
+        audioEnd = std::max(audioEnd, (uint64_t)time * Audio::FREQUENCY / 1000 + (uint64_t)((double)sample->Length() * Audio::FREQUENCY / rate));
+}
+
+bool Sys::Headless::recordAudio(const std::string &filename) {
+    return wav.open(filename);
+}
+
+void Sys::Headless::renderAudio(uint64_t until) {
+    int64_t start = Common::FramePacer::Now();
+
+    while (samples < until) {
+        size_t length = (size_t)std::min<uint64_t>(until - samples, mix.size() / 2);
+
+        mixer.mix(mix.data(), length);
+        Audio::ToPCM16(mix.data(), pcm16.data(), length * 2);
+
+        for (size_t i = 0; i < length * 2; i++) {
+            audioHash = (audioHash ^ (uint8_t)(pcm16[i] & 0xFF)) * 0x100000001b3ULL;
+            audioHash = (audioHash ^ (uint8_t)((pcm16[i] >> 8) & 0xFF)) * 0x100000001b3ULL;
+        }
+
+        if (wav.isOpen())
+            wav.write(pcm16.data(), length);
+
+        samples += length;
+    }
+
+    audioTime += Common::FramePacer::Now() - start;
+}
+
+void Sys::Headless::finishAudio() {
+    renderAudio(std::max(audioEnd, frameSample()));
+    wav.close();
+}
+
+std::string Sys::Headless::report() const {
+    std::stringstream out;
+
+    out << "Audio: " << samples << " samples in " << std::fixed << std::setprecision(1) << audioTime / 1000000.0 << "ms";
+
+    if (audioTime > 0)
+        out << ", " << (double)samples / Audio::FREQUENCY / (audioTime / 1000000000.0) << "x real time";
+
+    return out.str();
+}
@@ -0,0 +1,126 @@
+#ifndef __SYS_HEADLESS_H__
+#define __SYS_HEADLESS_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Sys/Base.h"
+#include "Client/State.h"
+#include "Audio/Mixer.h"
+#include "Audio/WAVFile.h"
+
+namespace Sys {
+    // Runs without a display or terminal. Time comes from a virtual clock
+    // that advances exactly one frame per handleEvents() call, and input
+    // from a script of timed events, one per line:
+    //
+    //   <frame> type <text>          press and release each character
+    //   <frame> key|down|up <key>    a character or a name like enter
+    //   <frame> move <x> <y>
+    //   <frame> press|release <left|middle|right> <x> <y>
+    //
+    // Blank lines and lines starting with # are ignored.
+    //
+    // Sound is rendered offline, a frame's worth of samples at the start
+    // of each frame, with fixed noise seeds so the same run always gives
+    // the same samples.
+    class Headless : public Base {
+            struct Event {
+                enum class Type {
+                    KeyDown,
+                    KeyUp,
+                    MouseMove,
+                    MouseDown,
+                    MouseUp
+                };
+
+                uint64_t frame;
+                Type type;
+                Client::KeyPress key;
+                Client::MouseMove move;
+                Client::MouseClick click;
+            };
+
+            const double rate;
+            const uint64_t frames;
+            uint64_t frame;
+
+            std::vector<Event> script;
+            size_t next;
+
+            Audio::Mixer mixer;
+            Audio::WAVFile wav;
+            std::vector<float> mix;
+            std::vector<int16_t> pcm16;
+            uint64_t samples;
+            uint64_t audioEnd;
+            uint64_t audioHash;
+            int64_t audioTime;
+
+            void load(const std::string &filename);
+            void renderAudio(uint64_t until);
+
+            // First output sample of the current frame, exact at any rate
+            uint64_t frameSample() const;
+        public:
+            // A frame limit of zero runs until stopped some other way
+            Headless(const std::string &script, uint64_t frames, double rate=60.0, size_t voices=Audio::DEFAULT_VOICES);
+            ~Headless();
+
+            Common::DisplayMode changeDisplayMode(const Common::DisplayMode &displayMode, bool fullscreen);
+            std::vector<Common::DisplayMode> getDisplayModes() const;
+            Common::DisplayMode findDisplayMode(uint16_t width, uint16_t height) const;
+            Common::DisplayMode currentDisplayMode() const;
+            std::pair<Common::DisplayMode, Common::DisplayMode> getPreviousNextMode(const Common::DisplayMode &displayMode) const;
+
+            bool isFullScreen() const {
+                return true;
+            }
+
+            // Milliseconds of virtual time, whole frames only. Truncating
+            // to whole milliseconds here is the only rounding left in the
+            // virtual clock, so note times are off by less than 1ms while
+            // frames themselves start on their exact sample.
+            uint32_t getTicks() const;
+
+            uint64_t Frame() const {
+                return frame;
+            }
+
+            // Whether every scripted event has been sent
+            bool scriptDone() const {
+                return next >= script.size();
+            }
+
+            void clearScreen() const {
+            }
+
+            void swapBuffers() {
+            }
+
+            bool handleEvents(std::shared_ptr<Client::State> clientState);
+
+            void keyRepeat(bool enable) {
+            }
+
+            void sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan);
+
+            // Also writes the audio to a .wav file, call before the first frame
+            bool recordAudio(const std::string &filename);
+
+            // Renders any notes still sounding and closes the .wav file
+            void finishAudio();
+
+            // FNV-1a over the 16 bit samples, stable across runs and platforms
+            uint64_t AudioHash() const {
+                return audioHash;
+            }
+
+            std::string report() const;
+    };
+}; // Sys
+
+#endif //__SYS_HEADLESS_H__
@@ -4,6 +4,9 @@
 #include "Sys/Base.h"
 #include "Client/State.h"
 
+#ifndef NCURSES_WIDECHAR
+#define NCURSES_WIDECHAR 1
+#endif
 #include <ncurses.h>
 
 #include <ctime>
@@ -35,17 +38,23 @@ namespace Sys {
 
             uint32_t getTicks() const;
 
+            // The renderer only rewrites cells that changed, clearing
+            // here would make curses repaint the whole window each frame.
             void clearScreen() const {
-                //clear();
-                wclear(window.get());
             }
 
-            void sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
+            void sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
                 if (frequency == 800.0f && duration == 250) {
                     beep();
                 }
             }
 
+            void play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+            }
+
+            void pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan) {
+            }
+
             void keyRepeat(bool enable) {
             }
     };
@@ -486,30 +486,22 @@ bool Sys::SDL2::handleEvents(std::shared_ptr<Client::State> clientState) {
     return run;
 }
 
-void Sys::SDL2::sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
-    SDL_LockAudioDevice(dev);
-    if (duration == 0) {
-        SDL_PauseAudioDevice(dev, 1);
-    } else {
-        voices[voice].tone(frequency, duration, waveForm, volume, attack, decay, sustain, release);
-    }
-    SDL_UnlockAudioDevice(dev);
+void Sys::SDL2::sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.sound(time, voice, frequency, duration, waveForm, volume, attack, decay, sustain, release, pan);
 }
 
-static void audio_callback(void *userData, uint8_t *_stream, int _length) {
-    float *stream = (float *) _stream;
-    int length = _length / 4;
-    Audio::Tone *voices = (Audio::Tone *)userData;
+void Sys::SDL2::play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.play(time, voice, sequence, delay, waveForm, volume, attack, decay, sustain, release, pan);
+}
 
-    std::vector<float> buffer;
-    buffer.resize(length, 0.0f);
+void Sys::SDL2::pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan) {
+    mixer.pcm(time, voice, sample, rate, volume, pan);
+}
 
-    voices[0].generateSamples(buffer.data(), length, 0.25);
-    voices[1].generateSamples(buffer.data(), length, 0.25);
-    voices[2].generateSamples(buffer.data(), length, 0.25);
-    voices[3].generateSamples(buffer.data(), length, 0.25);
+static void audio_callback(void *userData, uint8_t *_stream, int _length) {
+    Audio::Mixer *mixer = (Audio::Mixer *)userData;
 
-    std::memcpy(stream, buffer.data(), sizeof(float) * length);
+    mixer->mix((float *)_stream, _length / (2 * sizeof(float)));
 }
 
 #if defined(_WIN32)
@@ -527,7 +519,7 @@ static void setWindowsIcon(SDL_Window *sdlWindow) {
 }
 #endif
 
-Sys::SDL2::SDL2(const std::string &title) : repeatKeys(false) {
+Sys::SDL2::SDL2(const std::string &title, uint32_t period, size_t voices) : repeatKeys(false), mixer(period ? period : 4096, voices) {
     SDL_Init(SDL_INIT_EVERYTHING);
 
     auto mode = getDisplayModes().front();
@@ -564,18 +556,15 @@ Sys::SDL2::SDL2(const std::string &title) : repeatKeys(false) {
     //glClearColor(1.0, 1.0, 1.0, 1.0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    for (int i = 0; i < VOICE_COUNT; i++)
-        voices[i] = Audio::Tone();
-
     SDL_AudioSpec want;
     SDL_zero(want);
 
     want.freq = Audio::FREQUENCY;
     want.format = AUDIO_F32;
-    want.channels = 1;
-    want.samples = 4096;
+    want.channels = 2;
+    want.samples = mixer.Period();
     want.callback = audio_callback;
-    want.userdata = voices.data();
+    want.userdata = &mixer;
 
     SDL_AudioSpec have;
 
@@ -598,6 +587,9 @@ Sys::SDL2::SDL2(const std::string &title) : repeatKeys(false) {
         if (have.format != want.format) {
             SDL_Log("We didn't get audio format.");
         } else {
+            // SDL keeps about one buffer queued ahead of the device
+            mixer.setOutputLatency((double)have.samples / have.freq);
+
             // start play audio
             SDL_PauseAudioDevice(dev, 0);
         }
@@ -9,7 +9,7 @@
 
 #include "Sys/Base.h"
 #include "Client/State.h"
-#include "Audio/Tone.h"
+#include "Audio/Mixer.h"
 
 namespace Sys {
     class SDL2 : public Base {
@@ -23,9 +23,9 @@ namespace Sys {
 
             bool repeatKeys;
 
-            std::array<Audio::Tone, VOICE_COUNT> voices;
+            Audio::Mixer mixer;
         public:
-            SDL2(const std::string &title);
+            SDL2(const std::string &title, uint32_t period=0, size_t voices=Audio::DEFAULT_VOICES);
             ~SDL2();
             Common::DisplayMode changeDisplayMode(const Common::DisplayMode &displayMode, bool fullscreen);
             std::vector<Common::DisplayMode> getDisplayModes() const;
@@ -51,7 +51,13 @@ namespace Sys {
                 repeatKeys = enable;
             }
 
-            void sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release);
+            std::string report() const {
+                return mixer.report();
+            }
+
+            void sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan);
     };
 }; // Sys
 
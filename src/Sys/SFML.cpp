@@ -218,27 +218,26 @@ class ToneStream : public sf::SoundStream {
 #endif
 
 static int tonecallback(const void *inputBuffer, void *outputBuffer, unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData) {
-    Audio::Tone *voices = (Audio::Tone *)userData;
+    Audio::Mixer *mixer = (Audio::Mixer *)userData;
 
-    float *out = (float *)outputBuffer;
-    std::vector<float> buffer;
-    buffer.resize(framesPerBuffer, 0.0f);
+    mixer->mix((float *)outputBuffer, framesPerBuffer);
 
-    voices[0].generateSamples(buffer.data(), framesPerBuffer, 0.25);
-    voices[1].generateSamples(buffer.data(), framesPerBuffer, 0.25);
-    voices[2].generateSamples(buffer.data(), framesPerBuffer, 0.25);
-    voices[3].generateSamples(buffer.data(), framesPerBuffer, 0.25);
+    return 0;
+}
 
-    std::memcpy(out, buffer.data(), sizeof(float) * framesPerBuffer);
+void Sys::SFML::sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.sound(time, voice, frequency, duration, waveForm, volume, attack, decay, sustain, release, pan);
+}
 
-    return 0;
+void Sys::SFML::play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan) {
+    mixer.play(time, voice, sequence, delay, waveForm, volume, attack, decay, sustain, release, pan);
 }
 
-void Sys::SFML::sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release) {
-    voices[voice].tone(frequency, duration, waveForm, volume, attack, decay, sustain, release);
+void Sys::SFML::pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan) {
+    mixer.pcm(time, voice, sample, rate, volume, pan);
 }
 
-Sys::SFML::SFML(const std::string &title) : title(std::string("SFML ") + title), isFullscreen(false) {
+Sys::SFML::SFML(const std::string &title, uint32_t period, size_t voices) : title(std::string("SFML ") + title), isFullscreen(false), mixer(period ? period : 256, voices) {
     uint32_t style = sf::Style::Default;
 
     if (isFullscreen) {
@@ -256,23 +255,25 @@ Sys::SFML::SFML(const std::string &title) : title(std::string("SFML ") + title),
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    for (int i = 0; i < VOICE_COUNT; i++)
-        voices[i] = Audio::Tone();
-
 //    ToneStream stream(tone);
 //    stream.SetBufSize(256, 1, Audio::FREQUENCY);
 //    stream.play();
 
-    if (Pa_Initialize() == paNoError && Pa_OpenDefaultStream(
-        &stream,
-        0,          // no input channels
-        1,          // mono output
-        paFloat32,
-        Audio::FREQUENCY,
-        256,        // frames per buffer
-        tonecallback,
-        voices.data()
-    ) == paNoError && Pa_StartStream(stream) == paNoError);
+    // Ask for as little buffering as the period allows, the default
+    // stream uses the device's high latency setting.
+    PaStreamParameters output;
+
+    if (Pa_Initialize() == paNoError && (output.device = Pa_GetDefaultOutputDevice()) != paNoDevice) {
+        output.channelCount = 2;
+        output.sampleFormat = paFloat32;
+        output.suggestedLatency = (double)mixer.Period() / Audio::FREQUENCY;
+        output.hostApiSpecificStreamInfo = NULL;
+
+        if (Pa_OpenStream(&stream, NULL, &output, Audio::FREQUENCY, mixer.Period(), paNoFlag, tonecallback, &mixer) == paNoError && Pa_StartStream(stream) == paNoError) {
+            if (const PaStreamInfo *info = Pa_GetStreamInfo(stream))
+                mixer.setOutputLatency(info->outputLatency);
+        }
+    }
 
 }
 
@@ -11,7 +11,7 @@
 
 #include "Sys/Base.h"
 #include "Client/State.h"
-#include "Audio/Tone.h"
+#include "Audio/Mixer.h"
 
 namespace Sys {
     class SFML : public Base {
@@ -21,9 +21,9 @@ namespace Sys {
             const std::string title;
             bool isFullscreen;
             PaStream *stream;
-            std::array<Audio::Tone, VOICE_COUNT> voices;
+            Audio::Mixer mixer;
         public:
-            SFML(const std::string &title);
+            SFML(const std::string &title, uint32_t period=0, size_t voices=Audio::DEFAULT_VOICES);
             ~SFML();
             Common::DisplayMode changeDisplayMode(const Common::DisplayMode &displayMode, bool fullscreen);
             std::vector<Common::DisplayMode> getDisplayModes() const;
@@ -49,7 +49,13 @@ namespace Sys {
                 window.setKeyRepeatEnabled(enable);
             }
 
-            void sound(uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release);
+            std::string report() const {
+                return mixer.report();
+            }
+
+            void sound(uint32_t time, uint8_t voice, float frequency, uint16_t duration, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void play(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sequence> &sequence, uint32_t delay, uint8_t waveForm, uint8_t volume, uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release, uint8_t pan);
+            void pcm(uint32_t time, uint8_t voice, const std::shared_ptr<const Audio::Sample> &sample, float rate, uint8_t volume, uint8_t pan);
     };
 }; // Sys
 
@@ -1,9 +1,12 @@
 #include <cstdlib>
+#include <clocale>
 #include <memory>
 #include <functional>
 #include <map>
+#include <array>
 
 #include <iostream>
+#include <iomanip>
 
 #include <ctime>
 #include <ratio>
@@ -28,23 +31,27 @@
 #ifdef __EMSCRIPTEN__
 #include <gl4esinit.h>
 #include "Renderer/Immediate.h"
-#else
+#elif !HEADLESS
 #include "Renderer/Immediate.h"
 #endif
 
 #include "Common/DisplayMode.h"
+#include "Common/FramePacer.h"
 
-#if MINBUILD
+#include "Renderer/Software.h"
+#include "Sys/Headless.h"
+
+#if MINBUILD || HEADLESS
 #else
 #include "Sys/SDL2.h"
 #endif
 
-#ifndef __EMSCRIPTEN__
+#if !defined(__EMSCRIPTEN__) && !HEADLESS
 #include "Sys/GLFW.h"
 #endif
 
 #ifndef _WIN32
-#ifndef __EMSCRIPTEN__
+#if !defined(__EMSCRIPTEN__) && !HEADLESS
 #include "Sys/NCurses.h"
 #include "Renderer/NCurses.h"
 #include "Sys/SFML.h"
@@ -58,6 +65,13 @@
 #include "Client/DebugState.h"
 #include "Client/DisplayMenuState.h"
 #include "Client/EmulatorState.h"
+#include "Client/Capture.h"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include "Client/FrameExport.h"
+#endif
+
+#include "Benchmark.h"
 
 #define CLOCK_8MHz_at_60FPS   133333
 #define CLOCK_16MHz_at_60FPS  266667
@@ -68,6 +82,18 @@
 #define CLOCK_166MHz_at_60FPS  2766667
 #define CLOCK_200MHz_at_60FPS  3333333
 
+// Cycle budgets selectable with -t, indexed by turbo mode
+static const std::array<uint32_t, 8> clockspeeds = {
+    CLOCK_8MHz_at_60FPS,
+    CLOCK_16MHz_at_60FPS,
+    CLOCK_33MHz_at_60FPS,
+    CLOCK_66MHz_at_60FPS,
+    CLOCK_100MHz_at_60FPS,
+    CLOCK_133MHz_at_60FPS,
+    CLOCK_166MHz_at_60FPS,
+    CLOCK_200MHz_at_60FPS
+};
+
 #ifdef SYS32
     #define EXEHEADER "GR32"
     #define APPNAME "Grape32"
@@ -146,6 +172,7 @@ void emscripten_loop(void *userdata) {
         renderTime = sys->getTicks();
         clientState->tick(renderTime - lastRender);
         clientState->render(renderTime - lastRender);
+        clientState->getRenderer()->flush();
 
         sys->swapBuffers();
 
@@ -261,7 +288,7 @@ int main(int argc, char **argv) {
         0, // Required?
         1, // Number of args expected.
         0, // Delimiter if expecting multiple args.
-        "CPU speed (0=8MHz, 1=16MHz, 2=33MHz, 3=66MHz, 4=100MHz, 5=133MHz, 6=166Mhz, 7=200MHz)", // Help description.
+        "CPU speed (0=8MHz, 1=16MHz, 2=33MHz, 3=66MHz, 4=100MHz, 5=133MHz, 6=166Mhz, 7=200MHz, other=fast-forward)", // Help description.
         "-t",     // Flag token.
         "-turbo",   // Flag token.
         "--turbo"  // Flag token.
@@ -298,7 +325,137 @@ int main(int argc, char **argv) {
     );
 
     opt.add(
-#ifdef _WIN32
+        "0", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Target frame rate in Hz (0=display refresh)", // Help description.
+        "--fps"  // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        0, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Report frame timing statistics on exit", // Help description.
+        "--stats"  // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        0, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Run emulation on the render thread", // Help description.
+        "--single-thread" // Flag token.
+    );
+
+    opt.add(
+        "0", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Render every Nth frame when fast-forwarding (0=display rate), toggle fast-forward with F3", // Help description.
+        "--frameskip" // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        2, // Number of args expected.
+        ',', // Delimiter if expecting multiple args.
+        "Scale CPU speed between two -t settings to hold the frame rate, e.g. 0,7", // Help description.
+        "--governor" // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Run a micro benchmark and exit (palette, dsp, compile)", // Help description.
+        "--bench" // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Record video to a .y4m file, or raw RGB24 frames for any other name", // Help description.
+        "--capture" // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Record audio to a .wav file, headless runs also print its hash", // Help description.
+        "--capture-audio" // Flag token.
+    );
+
+    opt.add(
+        "0", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Audio period in frames, 128-512 for low latency (0=4096 for sdl2, 256 otherwise)", // Help description.
+        "--audio-period" // Flag token.
+    );
+
+    opt.add(
+        "32", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Notes that can sound at once before voices are stolen", // Help description.
+        "--voices" // Flag token.
+    );
+
+#ifndef _WIN32
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Export each frame to a POSIX shared memory segment, e.g. /grape16", // Help description.
+        "--shm" // Flag token.
+    );
+#endif
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Input script for the headless system, see Sys/Headless.h", // Help description.
+        "--script" // Flag token.
+    );
+
+    opt.add(
+        "0", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Frames to run the headless system for (0=until the program halts)", // Help description.
+        "--frames" // Flag token.
+    );
+
+    opt.add(
+        "", // Default.
+        0, // Required?
+        1, // Number of args expected.
+        0, // Delimiter if expecting multiple args.
+        "Save the final headless frame as .png or .ppm", // Help description.
+        "--dump" // Flag token.
+    );
+
+    opt.add(
+#if HEADLESS
+        "headless", // Default.
+#elif defined(_WIN32)
 #if MINBUILD
         "glfw", // Default.
 #else
@@ -310,7 +467,7 @@ int main(int argc, char **argv) {
         0, // Required?
         1, // Number of args expected.
         0, // Delimiter if expecting multiple args.
-        "Display usage instructions.", // Help description.
+        "System (sdl2, glfw, sfml, ncurses, headless)", // Help description.
         "-s",     // Flag token.
         "-sys",  // Flag token.
         "--sys" // Flag token.
@@ -324,6 +481,12 @@ int main(int argc, char **argv) {
         std::cout << usage << std::endl;
         exit(1);
     }
+
+    if (opt.isSet("--bench")) {
+        std::string name;
+        opt.get("--bench")->getString(name);
+        exit(Benchmark::Run(name));
+    }
 #endif
 
     std::shared_ptr<Emulator::Program> program;
@@ -392,29 +555,62 @@ int main(int argc, char **argv) {
 
     opt.get("-s")->getString(sysname);
 
-    if (sysname == "glfw") {
-        sys = std::make_shared<Sys::GLFW>(APPNAME);
+    bool headless = sysname == "headless";
+
+    int period = 0;
+    opt.get("--audio-period")->getInt(period);
+    if (period < 0)
+        period = 0;
+
+    int voices = Audio::DEFAULT_VOICES;
+    opt.get("--voices")->getInt(voices);
+    if (voices < 1)
+        voices = 1;
+
+    if (headless) {
+        std::string script;
+        opt.get("--script")->getString(script);
+
+        int frames = 0;
+        opt.get("--frames")->getInt(frames);
+
+        double rate = 0.0;
+        opt.get("--fps")->getDouble(rate);
+
+        if (opt.isSet("-r"))
+            rate = 30.0;
+        else if (rate <= 0.0)
+            rate = 60.0;
+
+        sys = std::make_shared<Sys::Headless>(script, frames > 0 ? frames : 0, rate, voices);
+        renderer = std::make_shared<Renderer::Software>();
+#if !HEADLESS
+    } else if (sysname == "glfw") {
+        sys = std::make_shared<Sys::GLFW>(APPNAME, period, voices);
         renderer = std::make_shared<Renderer::Immediate>(sys->currentDisplayMode(), Common::AspectRatio::_4x3, 2);
 #if MINBUILD
 #else
     } else if (sysname == "sdl2") {
-        sys = std::make_shared<Sys::SDL2>(APPNAME);
+        sys = std::make_shared<Sys::SDL2>(APPNAME, period, voices);
         renderer = std::make_shared<Renderer::Immediate>(sys->currentDisplayMode());
 #endif
 #ifndef _WIN32
     } else if (sysname == "sfml") {
-        sys = std::make_shared<Sys::SFML>(APPNAME);
+        sys = std::make_shared<Sys::SFML>(APPNAME, period, voices);
         renderer = std::make_shared<Renderer::Immediate>(sys->currentDisplayMode());
     } else if (sysname == "ncurses") {
+        // Needed for the half block characters
+        setlocale(LC_ALL, "");
         initscr();
 
         auto window = std::shared_ptr<WINDOW>(
-            newwin(24, 42, 0, 0),
+            newwin(LINES, COLS, 0, 0),
             delwin
         );
 
         sys = std::make_shared<Sys::NCurses>(APPNAME, window);
         renderer = std::make_shared<Renderer::NCurses>(window);
+#endif
 #endif
     } else {
         std::cerr << "Unknown system" << std::endl;
@@ -422,37 +618,34 @@ int main(int argc, char **argv) {
     }
 
     uint32_t clockspeed = CLOCK_33MHz_at_60FPS;
+    bool fastForward = false;
     int turbomode;
     opt.get("-t")->getInt(turbomode);
 
-    switch(turbomode) {
-        case 0:
-            clockspeed = CLOCK_8MHz_at_60FPS;
-            break;
-        case 1:
-            clockspeed = CLOCK_16MHz_at_60FPS;
-            break;
-        case 2:
-            clockspeed = CLOCK_33MHz_at_60FPS;
-            break;
-        case 3:
-            clockspeed = CLOCK_66MHz_at_60FPS;
-            break;
-        case 4:
-            clockspeed = CLOCK_100MHz_at_60FPS;
-            break;
-        case 5:
-            clockspeed = CLOCK_133MHz_at_60FPS;
-            break;
-        case 6:
-            clockspeed = CLOCK_166MHz_at_60FPS;
-            break;
-        case 7:
-            clockspeed = CLOCK_200MHz_at_60FPS;
-            break;
-        default:
-            clockspeed = UINT32_MAX;
-            break;
+    if (turbomode >= 0 && turbomode < (int)clockspeeds.size()) {
+        clockspeed = clockspeeds[turbomode];
+    } else {
+        clockspeed = CLOCK_200MHz_at_60FPS;
+        // Headless already runs as fast as it can
+        fastForward = !headless;
+    }
+
+    uint32_t minBudget = 0;
+    uint32_t maxBudget = 0;
+
+    // The governor reacts to host timing, which would make headless
+    // runs differ from one machine to the next.
+    if (opt.isSet("--governor") && !headless) {
+        std::vector<int> bounds;
+        opt.get("--governor")->getInts(bounds);
+
+        if (bounds.size() != 2 || bounds[0] < 0 || bounds[1] >= (int)clockspeeds.size() || bounds[0] > bounds[1]) {
+            std::cerr << "Governor bounds must be two CPU speeds in increasing order" << std::endl;
+            exit(-1);
+        }
+
+        minBudget = clockspeeds[bounds[0]];
+        maxBudget = clockspeeds[bounds[1]];
     }
 
     uint32_t memsize = 0x003FFFFF;
@@ -490,6 +683,12 @@ int main(int argc, char **argv) {
 
 
     bool debug = opt.isSet("-d");
+    bool threaded = !opt.isSet("--single-thread") && !headless;
+
+    int frameskip = 0;
+    opt.get("--frameskip")->getInt(frameskip);
+    if (frameskip < 0)
+        frameskip = 0;
 #else
 
 #ifdef SYS32
@@ -500,6 +699,11 @@ int main(int argc, char **argv) {
     uint32_t memsize = 0x003FFFFF;
 #endif
     bool debug = false;
+    bool threaded = false;
+    bool fastForward = false;
+    int frameskip = 0;
+    uint32_t minBudget = 0;
+    uint32_t maxBudget = 0;
     sys = std::make_shared<Sys::SDL2>(APPNAME);
     renderer = std::make_shared<Renderer::Immediate>(sys->currentDisplayMode());
 #endif
@@ -509,9 +713,60 @@ int main(int argc, char **argv) {
     auto vm = std::make_shared<Emulator::VM>(memsize);
 
     auto debugState = std::make_shared<Client::DebugState>(vm, clockspeed);
-    auto emulatorState = std::make_shared<Client::EmulatorState>(vm, program, clockspeed, debug);
+    auto emulatorState = std::make_shared<Client::EmulatorState>(vm, program, clockspeed, debug, threaded, fastForward, frameskip, minBudget, maxBudget);
     auto displayMenuState = std::make_shared<Client::DisplayMenuState>();
 
+#ifndef __EMSCRIPTEN__
+    std::shared_ptr<Client::Capture> capture;
+
+    if (opt.isSet("--capture") || opt.isSet("--capture-audio")) {
+        std::string videoFilename;
+        std::string audioFilename;
+        opt.get("--capture")->getString(videoFilename);
+        opt.get("--capture-audio")->getString(audioFilename);
+
+        // The headless system renders its own audio in step with frames
+        if (headless) {
+            if (!audioFilename.empty() && !std::dynamic_pointer_cast<Sys::Headless>(sys)->recordAudio(audioFilename)) {
+                std::cerr << "Could not open `" << audioFilename << "'" << std::endl;
+                exit(-1);
+            }
+
+            audioFilename.clear();
+        }
+
+        // Headless runs have no real time to keep up with, so record
+        // every frame rather than dropping any.
+        if (!videoFilename.empty() || !audioFilename.empty())
+            capture = std::make_shared<Client::Capture>(videoFilename, audioFilename, 60.0, headless, voices);
+    }
+
+    if (capture) {
+        emulatorState->addFrameListener([capture](const std::shared_ptr<const Client::Frame> &frame) {
+            capture->frame(frame);
+        });
+
+        emulatorState->addSoundListener([capture](uint32_t time, const Client::SoundBufferObject &sound) {
+            capture->sound(time, sound);
+        });
+    }
+#endif
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    std::shared_ptr<Client::FrameExport> frameExport;
+
+    if (opt.isSet("--shm")) {
+        std::string name;
+        opt.get("--shm")->getString(name);
+
+        frameExport = std::make_shared<Client::FrameExport>(name);
+
+        emulatorState->addFrameListener([frameExport](const std::shared_ptr<const Client::Frame> &frame) {
+            frameExport->publish(*frame);
+        });
+    }
+#endif
+
     auto clientState = std::make_shared<Client::State>(
         std::dynamic_pointer_cast<Renderer::Base>(renderer),
         std::dynamic_pointer_cast<Sys::Base>(sys),
@@ -525,25 +780,100 @@ int main(int argc, char **argv) {
     auto args = std::pair<std::shared_ptr<Sys::Base>, std::shared_ptr<Client::State>>(sys, clientState);
     emscripten_set_main_loop_arg(emscripten_loop, (void *)&args, -1, 1);
 #else
-    static uint32_t lastRender = sys->getTicks();
-    uint32_t renderTime = sys->getTicks();
+    if (headless) {
+        auto headlessSys = std::dynamic_pointer_cast<Sys::Headless>(sys);
+        auto software = std::dynamic_pointer_cast<Renderer::Software>(renderer);
+        uint32_t last = sys->getTicks();
+
+        // Each pass is one frame of virtual time, so runs are repeatable
+        // however fast the host is.
+        while (sys->handleEvents(clientState)) {
+            uint32_t now = sys->getTicks();
+            clientState->tick(now - last);
+            last = now;
+
+            // Scripted input may still be meant for the prompt
+            if (emulatorState->Halted() && headlessSys->scriptDone())
+                break;
+        }
+
+        clientState->render(0);
+        renderer->flush();
+        headlessSys->finishAudio();
+
+        std::cout << std::hex << std::setw(16) << std::setfill('0') << software->Hash() << std::dec << std::endl;
+
+        if (opt.isSet("--capture-audio"))
+            std::cout << std::hex << std::setw(16) << std::setfill('0') << headlessSys->AudioHash() << std::dec << std::endl;
+
+        if (opt.isSet("--dump")) {
+            std::string filename;
+            opt.get("--dump")->getString(filename);
+
+            bool png = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".png") == 0;
+            if (!(png ? software->savePNG(filename) : software->savePPM(filename))) {
+                std::cerr << "Could not write `" << filename << "'" << std::endl;
+                exit(-1);
+            }
+        }
+
+        if (opt.isSet("--stats")) {
+            std::cerr << "Frames: " << headlessSys->Frame() << std::endl;
+            std::cerr << sys->report() << std::endl;
+        }
+
+        if (capture) {
+            capture->stop(emulatorState->Clock());
+            std::cerr << capture->report() << std::endl;
+        }
+
+        exit(0);
+    }
+
+    double rate = 0.0;
+    opt.get("--fps")->getDouble(rate);
+
+    if (opt.isSet("-r"))
+        rate = 30.0;
+    else if (rate <= 0.0)
+        rate = sys->currentDisplayMode().Refresh() ? sys->currentDisplayMode().Refresh() : 60.0;
+
+    Common::FramePacer pacer(rate);
+    int64_t elapsed = pacer.Period();
 
     while (sys->handleEvents(clientState)) {
-        lastRender = renderTime;
+        uint32_t delta = pacer.elapsedMilliseconds(elapsed);
 
-        auto t1 = std::chrono::high_resolution_clock::now();
-        sys->clearScreen();
-        renderTime = sys->getTicks();
-        clientState->tick(renderTime - lastRender);
-        clientState->render(renderTime - lastRender);
+        clientState->tick(delta);
 
-        sys->swapBuffers();
+        // Leave the last frame up rather than redrawing an identical one
+        if (clientState->needsRender()) {
+            sys->clearScreen();
+            clientState->render(delta);
+            renderer->flush();
 
-        auto t4 = std::chrono::high_resolution_clock::now();
-        auto taken = std::chrono::duration_cast<std::chrono::milliseconds>(t4 - t1).count();
+            sys->swapBuffers();
+        }
 
-        if (std::chrono::milliseconds(16 - taken).count() > 0)
-            std::this_thread::sleep_for(std::chrono::milliseconds(16 - taken));
+        elapsed = pacer.wait();
+    }
+
+    emulatorState->stop();
+
+    if (capture) {
+        capture->stop(emulatorState->Clock());
+        std::cerr << capture->report() << std::endl;
+    }
+
+    if (opt.isSet("--stats")) {
+        std::cerr << pacer.report("Render") << std::endl;
+        if (!renderer->report().empty())
+            std::cerr << renderer->report() << std::endl;
+        if (!sys->report().empty())
+            std::cerr << sys->report() << std::endl;
+        if (threaded)
+            std::cerr << emulatorState->Pacer().report("Emulation") << std::endl;
+        std::cerr << emulatorState->report() << std::endl;
     }
 #endif
 